@@ -30,7 +30,14 @@ namespace ChimeraTK {
 
     /** Make any read blocking until new data has arrived since the last read. This flag may not be suppoerted by
      *  all registers (and backends), in which case a DeviceException with the id NOT_IMPLEMENTED will be thrown. */
-    wait_for_new_data
+    wait_for_new_data,
+
+    /** Saturate instead of throwing when a value read from the device does not fit into the UserType: such values
+     *  are replaced by the minimum resp. maximum value of the UserType. The number of replaced values in the last
+     *  read transfer can be obtained through getNumberOfOverflows(). This flag is only meaningful for registers which
+     *  are converted by the FixedPointConverter. It may not be supported by all registers (and backends), in which
+     *  case a DeviceException with the id NOT_IMPLEMENTED will be thrown. */
+    saturate
 
     /* IMPORTANT: When adding flags, don't forget to update AccessModeFlags::getStringMap()! */
   };
@@ -88,6 +95,7 @@ namespace ChimeraTK {
         static std::map<AccessMode, std::string> m;
         m[AccessMode::raw] = "raw";
         m[AccessMode::wait_for_new_data] = "wait_for_new_data";
+        m[AccessMode::saturate] = "saturate";
         return m;
        }
   };
@@ -0,0 +1,142 @@
+/*
+ * ContiguousTwoDRegisterAccessor.h
+ */
+
+#ifndef CHIMERA_TK_CONTIGUOUS_TWO_D_REGISTER_ACCESSOR_H
+#define CHIMERA_TK_CONTIGUOUS_TWO_D_REGISTER_ACCESSOR_H
+
+#include <algorithm>
+#include <vector>
+
+#include "TwoDRegisterAccessor.h"
+
+namespace ChimeraTK {
+
+  /** Non-owning view of the samples of one channel, similar to std::span. It stays valid as long as the
+   *  ContiguousTwoDRegisterAccessor it was obtained from exists. */
+  template<class UserType>
+  class ChannelView {
+
+    public:
+
+      ChannelView(UserType *data, size_t size)
+      : _data(data), _size(size) {}
+
+      UserType& operator[](size_t sample) const { return _data[sample]; }
+
+      UserType* data() const { return _data; }
+      size_t size() const { return _size; }
+      bool empty() const { return _size == 0; }
+
+      UserType* begin() const { return _data; }
+      UserType* end() const { return _data + _size; }
+
+    private:
+
+      UserType *_data;
+      size_t _size;
+  };
+
+  /** Opt-in alternative to the TwoDRegisterAccessor which keeps the data of all channels in a single contiguous
+   *  channel-major array, i.e. sample s of channel c is at data()[c*getNElementsPerChannel() + s]. The whole block can
+   *  hence be handed to numeric libraries without copying, and walking all channels stays within one allocation.
+   *  Individual channels are accessed through a ChannelView, which offers the same element access as the
+   *  std::vector returned by TwoDRegisterAccessor::operator[].
+   *
+   *  The accessor wraps a normal TwoDRegisterAccessor, so all backends and decorators keep exchanging their
+   *  per-channel buffers. The data is copied once between these buffers and the contiguous array in read() resp.
+   *  write(). If the wrapped accessor is transferred in a TransferGroup, call copyFromAccessor() after
+   *  TransferGroup::read() and copyToAccessor() before TransferGroup::write(). */
+  template<class UserType>
+  class ContiguousTwoDRegisterAccessor {
+
+    public:
+
+      /** Wrap the given accessor, e.g. obtained from Device::getTwoDRegisterAccessor(). */
+      explicit ContiguousTwoDRegisterAccessor(TwoDRegisterAccessor<UserType> accessor)
+      : _accessor(accessor),
+        _nElementsPerChannel(accessor.getNElementsPerChannel()),
+        _data(accessor.getNChannels()*_nElementsPerChannel)
+      {
+        copyFromAccessor();
+      }
+
+      /** Access the samples of one channel. */
+      ChannelView<UserType> operator[](size_t channel) {
+        return {_data.data() + channel*_nElementsPerChannel, _nElementsPerChannel};
+      }
+
+      /** Access the samples of one channel. */
+      ChannelView<const UserType> operator[](size_t channel) const {
+        return {_data.data() + channel*_nElementsPerChannel, _nElementsPerChannel};
+      }
+
+      /** Return the contiguous array holding all channels. */
+      UserType* data() { return _data.data(); }
+
+      /** Return the contiguous array holding all channels. */
+      const UserType* data() const { return _data.data(); }
+
+      /** Return the number of channels */
+      size_t getNChannels() const { return _accessor.getNChannels(); }
+
+      /** Return number of elements/samples per channel */
+      size_t getNElementsPerChannel() const { return _nElementsPerChannel; }
+
+      /** Read the data from the device, see TransferElementAbstractor::read(). */
+      void read() {
+        _accessor.read();
+        copyFromAccessor();
+      }
+
+      /** Read the next value if available, see TransferElementAbstractor::readNonBlocking(). */
+      bool readNonBlocking() {
+        if(!_accessor.readNonBlocking()) return false;
+        copyFromAccessor();
+        return true;
+      }
+
+      /** Read the latest value, see TransferElementAbstractor::readLatest(). */
+      bool readLatest() {
+        bool hasNewData = _accessor.readLatest();
+        if(hasNewData) copyFromAccessor();
+        return hasNewData;
+      }
+
+      /** Write the data to the device, see TransferElementAbstractor::write(). */
+      bool write(ChimeraTK::VersionNumber versionNumber={}) {
+        copyToAccessor();
+        return _accessor.write(versionNumber);
+      }
+
+      /** Copy the buffers of the wrapped accessor into the contiguous array. Only needed if the wrapped accessor has
+       *  been transferred directly, e.g. in a TransferGroup. */
+      void copyFromAccessor() {
+        for(size_t channel = 0; channel < _accessor.getNChannels(); ++channel) {
+          auto &buffer = _accessor[channel];
+          std::copy(buffer.begin(), buffer.end(), _data.begin() + channel*_nElementsPerChannel);
+        }
+      }
+
+      /** Copy the contiguous array into the buffers of the wrapped accessor. Only needed if the wrapped accessor is
+       *  transferred directly, e.g. in a TransferGroup. */
+      void copyToAccessor() {
+        for(size_t channel = 0; channel < _accessor.getNChannels(); ++channel) {
+          auto begin = _data.begin() + channel*_nElementsPerChannel;
+          std::copy(begin, begin + _nElementsPerChannel, _accessor[channel].begin());
+        }
+      }
+
+      /** Return the wrapped accessor, e.g. to add it to a TransferGroup. */
+      TwoDRegisterAccessor<UserType>& getAccessor() { return _accessor; }
+
+    private:
+
+      TwoDRegisterAccessor<UserType> _accessor;
+      size_t _nElementsPerChannel;
+      std::vector<UserType> _data;
+  };
+
+} // namespace ChimeraTK
+
+#endif /* CHIMERA_TK_CONTIGUOUS_TWO_D_REGISTER_ACCESSOR_H */
@@ -9,17 +9,45 @@
 #include <iostream>
 #include <limits>
 #include <type_traits>
+#include <algorithm>
+#include <mutex>
 
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/fusion/container.hpp>
 #include <boost/fusion/sequence.hpp>
 #include <boost/fusion/algorithm.hpp>
 
 #include "SupportedUserTypes.h"
 #include "NotImplementedException.h"
+#include "FixedPointConverterT.h"
 
 namespace ChimeraTK{
 
+  /** Lookup table holding the cooked values for all possible raw values of a narrow fixed point converter. Used by
+   *  the FixedPointConverter, see FixedPointConverter::enableLookupTable(). */
+  template<typename UserType>
+  struct FixedPointLookupTable {
+    /// flag to fill the table only once, on first use
+    std::once_flag isFilled;
+    /// cooked values as returned by toCookedSaturating(), indexed by the raw value
+    std::vector<UserType> values;
+    /// flags for each raw value, see below
+    std::vector<uint8_t> flags;
+    /// flag: toCookedSaturating() saturates the value
+    static constexpr uint8_t saturated = 1;
+    /// flag: the value differs from toCooked(), which might throw. The element-wise conversion must be used.
+    static constexpr uint8_t differs = 2;
+  };
+
+  template<typename UserType>
+  constexpr uint8_t FixedPointLookupTable<UserType>::saturated;
+  template<typename UserType>
+  constexpr uint8_t FixedPointLookupTable<UserType>::differs;
+
+  template<typename UserType>
+  using FixedPointLookupTablePtr = boost::shared_ptr<FixedPointLookupTable<UserType>>;
+
   /** The fixed point converter provides conversion functions
    *  between a user type and up to 32 bit fixed point (signed or unsigned).
    */
@@ -57,6 +85,40 @@ namespace ChimeraTK{
       template<typename UserType>
       uint32_t toRaw(UserType cookedValue) const;
 
+      /** Bulk conversion of n fixed point values into type T. The result is identical to calling toCooked() for each
+       *  element, but the decisions depending on the converter configuration are made only once per call. If no
+       *  overflow can occur for the given UserType, the conversion is done in a tight loop without range checks and
+       *  exceptions which can be vectorised by the compiler. For commonly used register layouts, a kernel of the
+       *  FixedPointConverterT with all parameters known at compile time is used (selected in reconfigure()).
+       *  Otherwise the elements are converted one by one, which throws in case of an overflow like toCooked() does.
+       */
+      template<typename UserType>
+      void toCooked(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+
+      /** Bulk conversion of n values of type T into fixed point. The result is identical to calling toRaw() for each
+       *  element. See the bulk version of toCooked() for details.
+       */
+      template<typename UserType>
+      void toRaw(const UserType *cookedValues, uint32_t *rawValues, size_t n) const;
+
+      /** Bulk conversion of n fixed point values into type T, which never throws. Values which do not fit into the
+       *  UserType are replaced by the minimum resp. maximum value of the UserType. Otherwise the result is identical
+       *  to the bulk version of toCooked(). Returns the number of replaced values.
+       */
+      template<typename UserType>
+      size_t toCookedSaturating(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+
+      /** Use lookup tables for the bulk conversions into cooked values. The table for each UserType contains the
+       *  cooked values of all possible raw values and is filled on first use. This replaces the arithmetics and range
+       *  checks by a single indexed load per value, which pays off for layouts without a compile-time specialised
+       *  kernel (e.g. with fractional bits and integer UserTypes). The tables are shared between all converters with
+       *  the same configuration (see operator==). Only converters with up to maxLookupTableBits bits use lookup
+       *  tables, for wider converters this function has no effect. The setting persists through reconfigure(). */
+      void enableLookupTable();
+
+      /** Maximum number of bits for which enableLookupTable() has an effect */
+      static constexpr unsigned int maxLookupTableBits = 16;
+
       /** \deprecated
        *  This function is deprecated. Use toCooked() instead!
        *  @todo Add printed runtime warning after release of version 0.6
@@ -137,6 +199,23 @@ namespace ChimeraTK{
       /// minimum cooked values (depending on user type)
       userTypeMap _minCookedValues;
 
+      /// compile-time specialised conversion kernels for the current configuration (nullptr if not available)
+      TemplateUserTypeMap<FixedPointToCookedKernel> _toCookedKernels;
+      TemplateUserTypeMap<FixedPointToRawKernel> _toRawKernels;
+
+      /// flag whether enableLookupTable() has been called
+      bool _useLookupTable;
+
+      /// lookup tables for the current configuration (nullptr if not used or not available for the UserType)
+      TemplateUserTypeMap<FixedPointLookupTablePtr> _lookupTables;
+
+      /// obtain the lookup tables from the global registry resp. clear them, depending on _useLookupTable and _nBits
+      void updateLookupTables();
+
+      /// return the lookup table for the UserType, or nullptr if not used. The table is filled on first use.
+      template<typename UserType>
+      const FixedPointLookupTable<UserType>* getLookupTable() const;
+
       /// helper constant to avoid the "comparison always false" warning. will be always 0
       const static int zero;
 
@@ -171,6 +250,10 @@ namespace ChimeraTK{
           FixedPointConverter *_fpc;
       };
 
+      /// helper class to select the compile-time specialised kernels for all possible UserTypes. Defined in the
+      /// source file, since it instantiates the FixedPointConverterT for all pre-defined register layouts.
+      class selectKernels;
+
       /** define round type for the boost::numeric::converter */
       template<class S>
       struct Round {
@@ -189,6 +272,25 @@ namespace ChimeraTK{
       template<typename UserType, typename std::enable_if<!std::is_signed<UserType>{}, int>::type = 0>
       bool isNegativeUserType(UserType value) const;
 
+      /** helper functions for the bulk conversions: convert all elements in a tight loop without range checks. Return
+       *  false without touching the data if an overflow could occur for the given UserType (or the UserType is not a
+       *  numeric type), in which case the element-wise conversion has to be used. */
+      template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type = 0>
+      bool toCookedUnchecked(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+      template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type = 0>
+      bool toCookedUnchecked(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+      template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type = 0>
+      bool toRawUnchecked(const UserType *cookedValues, uint32_t *rawValues, size_t n) const;
+      template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type = 0>
+      bool toRawUnchecked(const UserType *cookedValues, uint32_t *rawValues, size_t n) const;
+
+      /** helper function for toCookedSaturating(): convert all elements with a range check against the UserType limits
+       *  instead of throwing. Returns the number of saturated values. */
+      template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type = 0>
+      size_t toCookedClamped(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+      template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type = 0>
+      size_t toCookedClamped(const uint32_t *rawValues, UserType *cookedValues, size_t n) const;
+
       /** Internal exceptions to overload the what() function of the boost exceptions in order to fill in the variable name.
        *  We derrive from the original exception so we do not break the signature in case existing code is catching the exception.
        *  These exceptions are not part of the external interface and cannot be caught explicitly because they are private.
@@ -361,6 +463,264 @@ namespace ChimeraTK{
     return false;
   }
 
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  void FixedPointConverter::toCooked(const uint32_t *rawValues, UserType *cookedValues, size_t n) const {
+    auto kernel = boost::fusion::at_key<UserType>(_toCookedKernels.table);
+    if(kernel) {
+      kernel(rawValues, cookedValues, n);
+      return;
+    }
+    auto lookupTable = getLookupTable<UserType>();
+    if(lookupTable) {
+      const UserType *values = lookupTable->values.data();
+      const uint8_t *flags = lookupTable->flags.data();
+      const uint32_t usedBitsMask = _usedBitsMask;
+      uint8_t anyFlag = 0;
+      for(size_t i = 0; i < n; ++i) {
+        uint32_t index = rawValues[i] & usedBitsMask;
+        cookedValues[i] = values[index];
+        anyFlag |= flags[index];
+      }
+      if(anyFlag) {
+        // Use the element-wise conversion for values which are not identical in the table. This will also throw the
+        // right exception for the first overflowing value.
+        for(size_t i = 0; i < n; ++i) {
+          if(flags[rawValues[i] & usedBitsMask] & FixedPointLookupTable<UserType>::differs) {
+            cookedValues[i] = toCooked<UserType>(rawValues[i]);
+          }
+        }
+      }
+      return;
+    }
+    if(toCookedUnchecked(rawValues, cookedValues, n)) return;
+    for(size_t i = 0; i < n; ++i) {
+      cookedValues[i] = toCooked<UserType>(rawValues[i]);
+    }
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  void FixedPointConverter::toRaw(const UserType *cookedValues, uint32_t *rawValues, size_t n) const {
+    auto kernel = boost::fusion::at_key<UserType>(_toRawKernels.table);
+    if(kernel) {
+      kernel(cookedValues, rawValues, n);
+      return;
+    }
+    if(toRawUnchecked(cookedValues, rawValues, n)) return;
+    for(size_t i = 0; i < n; ++i) {
+      rawValues[i] = toRaw<UserType>(cookedValues[i]);
+    }
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  size_t FixedPointConverter::toCookedSaturating(const uint32_t *rawValues, UserType *cookedValues, size_t n) const {
+    // if no overflow is possible, the fast conversions can be used
+    auto kernel = boost::fusion::at_key<UserType>(_toCookedKernels.table);
+    if(kernel) {
+      kernel(rawValues, cookedValues, n);
+      return 0;
+    }
+    auto lookupTable = getLookupTable<UserType>();
+    if(lookupTable) {
+      const UserType *values = lookupTable->values.data();
+      const uint8_t *flags = lookupTable->flags.data();
+      const uint32_t usedBitsMask = _usedBitsMask;
+      size_t nOverflows = 0;
+      for(size_t i = 0; i < n; ++i) {
+        uint32_t index = rawValues[i] & usedBitsMask;
+        cookedValues[i] = values[index];
+        nOverflows += flags[index] & FixedPointLookupTable<UserType>::saturated;
+      }
+      return nOverflows;
+    }
+    if(toCookedUnchecked(rawValues, cookedValues, n)) return 0;
+    return toCookedClamped(rawValues, cookedValues, n);
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type>
+  bool FixedPointConverter::toCookedUnchecked(const uint32_t *rawValues, UserType *cookedValues, size_t n) const {
+
+    // Copy the configuration into local variables. Otherwise the compiler has to assume that writing to the target
+    // array might modify the member variables, which prevents vectorisation.
+    const uint32_t usedBitsMask = _usedBitsMask;
+    const int64_t signBitMask = _signBitMask;
+    const double fractionalBitsCoefficient = _fractionalBitsCoefficient;
+    const bool integerConversion = std::numeric_limits<UserType>::is_integer && _fractionalBits == 0;
+
+    // Compute the range of the cooked values, exactly like toCooked() would do. The sign extension used below
+    // flips the sign bit and subtracts it again, so the two's complement is interpreted correctly for any number
+    // of bits.
+    double minCooked = fractionalBitsCoefficient * static_cast<double>(static_cast<int64_t>(_minRawValue ^ _signBitMask) - signBitMask);
+    double maxCooked = fractionalBitsCoefficient * static_cast<double>(_maxRawValue);
+    if(std::numeric_limits<UserType>::is_integer) {
+      minCooked = std::round(minCooked);
+      maxCooked = std::round(maxCooked);
+      // Compare against 2^digits instead of max(), since max() of 64 bit types cannot be represented in a double.
+      if(minCooked < static_cast<double>(std::numeric_limits<UserType>::lowest())) return false;
+      if(maxCooked >= std::ldexp(1., std::numeric_limits<UserType>::digits)) return false;
+    }
+    else {
+      if(minCooked < static_cast<double>(std::numeric_limits<UserType>::lowest())) return false;
+      if(maxCooked > static_cast<double>(std::numeric_limits<UserType>::max())) return false;
+    }
+
+    // No overflow possible: convert without range checks. Since the fractional bits coefficient is a power of two,
+    // scaling the sign-extended value gives bit-identical results to the element-wise conversion.
+    if(integerConversion) {
+      for(size_t i = 0; i < n; ++i) {
+        int64_t value = static_cast<int64_t>((rawValues[i] & usedBitsMask) ^ signBitMask) - signBitMask;
+        cookedValues[i] = static_cast<UserType>(value);
+      }
+    }
+    else if(std::numeric_limits<UserType>::is_integer) {
+      for(size_t i = 0; i < n; ++i) {
+        int64_t value = static_cast<int64_t>((rawValues[i] & usedBitsMask) ^ signBitMask) - signBitMask;
+        cookedValues[i] = static_cast<UserType>(std::round(fractionalBitsCoefficient * static_cast<double>(value)));
+      }
+    }
+    else {
+      for(size_t i = 0; i < n; ++i) {
+        int64_t value = static_cast<int64_t>((rawValues[i] & usedBitsMask) ^ signBitMask) - signBitMask;
+        cookedValues[i] = static_cast<UserType>(fractionalBitsCoefficient * static_cast<double>(value));
+      }
+    }
+    return true;
+  }
+
+  template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type>
+  bool FixedPointConverter::toCookedUnchecked(const uint32_t *, UserType *, size_t) const {
+    return false;
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type>
+  bool FixedPointConverter::toRawUnchecked(const UserType *cookedValues, uint32_t *rawValues, size_t n) const {
+
+    // local copies of the configuration, see toCookedUnchecked()
+    const uint32_t usedBitsMask = _usedBitsMask;
+    const uint32_t minRawValue = _minRawValue;
+    const uint32_t maxRawValue = _maxRawValue;
+    const UserType minCookedValue = boost::fusion::at_key<UserType>(_minCookedValues);
+    const UserType maxCookedValue = boost::fusion::at_key<UserType>(_maxCookedValues);
+    const double inverseFractionalBitsCoefficient = _inverseFractionalBitsCoefficient;
+
+    if(std::numeric_limits<UserType>::is_integer && _fractionalBits == 0) {
+      for(size_t i = 0; i < n; ++i) {
+        // Values outside the range are replaced by the minimum resp. maximum raw value like in toRaw(). The value is
+        // clamped before the conversion, so the conversion itself is always well defined.
+        UserType value = std::min(std::max(cookedValues[i], minCookedValue), maxCookedValue);
+        uint32_t raw = static_cast<uint32_t>(static_cast<int64_t>(value)) & usedBitsMask;
+        raw = cookedValues[i] < minCookedValue ? minRawValue : raw;
+        rawValues[i] = cookedValues[i] > maxCookedValue ? maxRawValue : raw;
+      }
+      return true;
+    }
+
+    // The element-wise conversion throws (or returns the minimum raw value) if the scaled value does not fit into a
+    // 32 bit integer, which can happen in some corner cases due to rounding of the cooked limits. Use it in this case.
+    double minScaled = std::round(inverseFractionalBitsCoefficient * static_cast<double>(minCookedValue));
+    double maxScaled = std::round(inverseFractionalBitsCoefficient * static_cast<double>(maxCookedValue));
+    if(_isSigned) {
+      if(minScaled < std::numeric_limits<int32_t>::min() || maxScaled > std::numeric_limits<int32_t>::max()) return false;
+    }
+    else {
+      if(minScaled < 0 || maxScaled > std::numeric_limits<uint32_t>::max()) return false;
+    }
+
+    for(size_t i = 0; i < n; ++i) {
+      UserType value = std::min(std::max(cookedValues[i], minCookedValue), maxCookedValue);
+      double scaled = std::round(inverseFractionalBitsCoefficient * static_cast<double>(value));
+      uint32_t raw = static_cast<uint32_t>(static_cast<int64_t>(scaled)) & usedBitsMask;
+      raw = cookedValues[i] < minCookedValue ? minRawValue : raw;
+      rawValues[i] = cookedValues[i] > maxCookedValue ? maxRawValue : raw;
+    }
+    return true;
+  }
+
+  template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type>
+  bool FixedPointConverter::toRawUnchecked(const UserType *, uint32_t *, size_t) const {
+    return false;
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType, typename std::enable_if<std::is_arithmetic<UserType>{}, int>::type>
+  size_t FixedPointConverter::toCookedClamped(const uint32_t *rawValues, UserType *cookedValues, size_t n) const {
+
+    // local copies of the configuration, see toCookedUnchecked()
+    const uint32_t usedBitsMask = _usedBitsMask;
+    const int64_t signBitMask = _signBitMask;
+    const double fractionalBitsCoefficient = _fractionalBitsCoefficient;
+    const bool isInteger = std::numeric_limits<UserType>::is_integer;
+
+    // Limits of the UserType as doubles. For integers, 2^digits is used as an exclusive upper limit, since max() of
+    // 64 bit types cannot be represented in a double.
+    const double lowerLimit = static_cast<double>(std::numeric_limits<UserType>::lowest());
+    const double upperLimit = isInteger ? std::ldexp(1., std::numeric_limits<UserType>::digits)
+                                        : static_cast<double>(std::numeric_limits<UserType>::max());
+
+    size_t nOverflows = 0;
+    for(size_t i = 0; i < n; ++i) {
+      int64_t value = static_cast<int64_t>((rawValues[i] & usedBitsMask) ^ signBitMask) - signBitMask;
+      double cooked = fractionalBitsCoefficient * static_cast<double>(value);
+      if(isInteger) cooked = std::round(cooked);
+      if(cooked < lowerLimit) {
+        cookedValues[i] = std::numeric_limits<UserType>::lowest();
+        ++nOverflows;
+      }
+      else if(isInteger ? cooked >= upperLimit : cooked > upperLimit) {
+        cookedValues[i] = std::numeric_limits<UserType>::max();
+        ++nOverflows;
+      }
+      else {
+        cookedValues[i] = static_cast<UserType>(cooked);
+      }
+    }
+    return nOverflows;
+  }
+
+  template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>{}, int>::type>
+  size_t FixedPointConverter::toCookedClamped(const uint32_t *rawValues, UserType *cookedValues, size_t n) const {
+    // no overflow possible for non-numeric types
+    for(size_t i = 0; i < n; ++i) {
+      cookedValues[i] = toCooked<UserType>(rawValues[i]);
+    }
+    return 0;
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  const FixedPointLookupTable<UserType>* FixedPointConverter::getLookupTable() const {
+    const auto &table = boost::fusion::at_key<UserType>(_lookupTables.table);
+    if(!table) return nullptr;
+    std::call_once(table->isFilled, [this, &table] {
+      size_t size = size_t(1) << _nBits;
+      table->values.resize(size);
+      table->flags.resize(size);
+      for(size_t i = 0; i < size; ++i) {
+        uint32_t raw = static_cast<uint32_t>(i);
+        uint8_t flags = toCookedClamped(&raw, &table->values[i], 1) ? FixedPointLookupTable<UserType>::saturated : 0;
+        try {
+          if(toCooked<UserType>(raw) != table->values[i]) flags |= FixedPointLookupTable<UserType>::differs;
+        }
+        catch(boost::numeric::bad_numeric_cast &) {
+          flags |= FixedPointLookupTable<UserType>::differs;
+        }
+        table->flags[i] = flags;
+      }
+    });
+    return table.get();
+  }
+
   /**********************************************************************************************************************/
   template<>
   std::string FixedPointConverter::toCooked<std::string>(uint32_t rawValue) const;
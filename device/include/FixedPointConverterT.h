@@ -0,0 +1,175 @@
+#ifndef CHIMERA_TK_FIXED_POINT_CONVERTER_T_H
+#define CHIMERA_TK_FIXED_POINT_CONVERTER_T_H
+
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+namespace ChimeraTK {
+
+  /** Function pointer types for the bulk conversion kernels, see FixedPointConverterT. */
+  template<typename UserType>
+  using FixedPointToCookedKernel = void (*)(const uint32_t *rawValues, UserType *cookedValues, size_t n);
+  template<typename UserType>
+  using FixedPointToRawKernel = void (*)(const UserType *cookedValues, uint32_t *rawValues, size_t n);
+
+  namespace detail {
+    /** compile-time version of pow(2., exponent) */
+    constexpr double pow2(int exponent) {
+      return exponent == 0 ? 1. : (exponent > 0 ? 2. * pow2(exponent-1) : 0.5 * pow2(exponent+1));
+    }
+  }
+
+  /** Fixed point converter with the register layout known at compile time. It provides the same bulk conversions as
+   *  the FixedPointConverter, but all masks and coefficients are compile-time constants and all decisions depending
+   *  on the layout are taken by the compiler, so the conversion loops are branch free and can be vectorised.
+   *
+   *  Conversions which might overflow are not supported. Use canConvertToCooked() and canConvertToRaw() to check
+   *  whether a conversion is available for the given UserType, or obtain the kernels through getToCookedKernel() and
+   *  getToRawKernel(), which return nullptr in this case.
+   *
+   *  Usually there is no need to use this class directly: the FixedPointConverter automatically picks the kernels of
+   *  a pre-instantiated FixedPointConverterT if its layout matches one of the commonly used layouts.
+   */
+  template<unsigned int nBits, int fractionalBits, bool isSignedFlag>
+  class FixedPointConverterT {
+      static_assert(nBits > 0 && nBits <= 32, "The number of bits must be in the range 1 to 32.");
+
+    public:
+
+      /** Check if toCooked() is available for the given UserType, i.e. if the full raw range fits into the UserType.
+       *  Integer UserTypes are only supported without fractional bits. */
+      template<typename UserType>
+      static constexpr bool canConvertToCooked() {
+        return rangeFitsInto<UserType>();
+      }
+
+      /** Check if toRaw() is available for the given UserType. Supported are integer UserTypes without fractional
+       *  bits and double. */
+      template<typename UserType>
+      static constexpr bool canConvertToRaw() {
+        return ( std::numeric_limits<UserType>::is_integer && fractionalBits == 0 ) ||
+               std::is_same<UserType, double>::value;
+      }
+
+      /** Convert n raw values into the UserType. Only available if canConvertToCooked<UserType>() is true. */
+      template<typename UserType>
+      static void toCooked(const uint32_t *rawValues, UserType *cookedValues, size_t n) {
+        static_assert(canConvertToCooked<UserType>(), "Conversion not supported by FixedPointConverterT.");
+        for(size_t i = 0; i < n; ++i) {
+          cookedValues[i] = cook<UserType>(extract(rawValues[i]));
+        }
+      }
+
+      /** Convert n values of the UserType into raw values. Only available if canConvertToRaw<UserType>() is true.
+       *  Values outside the range are clamped to the minimum resp. maximum raw value, like the FixedPointConverter
+       *  does. */
+      template<typename UserType>
+      static void toRaw(const UserType *cookedValues, uint32_t *rawValues, size_t n) {
+        static_assert(canConvertToRaw<UserType>(), "Conversion not supported by FixedPointConverterT.");
+        const UserType minValue = minCooked<UserType>();
+        const UserType maxValue = maxCooked<UserType>();
+        for(size_t i = 0; i < n; ++i) {
+          rawValues[i] = uncook<UserType>(std::min(std::max(cookedValues[i], minValue), maxValue)) & usedBitsMask();
+        }
+      }
+
+      /** Obtain a pointer to toCooked() for the UserType, or nullptr if the conversion is not supported. */
+      template<typename UserType, typename std::enable_if<canConvertToCooked<UserType>(), int>::type = 0>
+      static FixedPointToCookedKernel<UserType> getToCookedKernel() {
+        return &toCooked<UserType>;
+      }
+      template<typename UserType, typename std::enable_if<!canConvertToCooked<UserType>(), int>::type = 0>
+      static FixedPointToCookedKernel<UserType> getToCookedKernel() {
+        return nullptr;
+      }
+
+      /** Obtain a pointer to toRaw() for the UserType, or nullptr if the conversion is not supported. */
+      template<typename UserType, typename std::enable_if<canConvertToRaw<UserType>(), int>::type = 0>
+      static FixedPointToRawKernel<UserType> getToRawKernel() {
+        return &toRaw<UserType>;
+      }
+      template<typename UserType, typename std::enable_if<!canConvertToRaw<UserType>(), int>::type = 0>
+      static FixedPointToRawKernel<UserType> getToRawKernel() {
+        return nullptr;
+      }
+
+    private:
+
+      /// The raw value after sign extension: int32_t if signed, uint32_t otherwise
+      typedef typename std::conditional<isSignedFlag, int32_t, uint32_t>::type ExtractedType;
+
+      static constexpr uint32_t usedBitsMask() { return nBits == 32 ? 0xFFFFFFFF : (1U << nBits) - 1U; }
+      static constexpr int64_t minRaw() { return isSignedFlag ? -(int64_t(1) << (nBits-1)) : 0; }
+      static constexpr int64_t maxRaw() { return isSignedFlag ? (int64_t(1) << (nBits-1)) - 1 : usedBitsMask(); }
+      static constexpr double coefficient() { return detail::pow2(-fractionalBits); }
+      static constexpr double inverseCoefficient() { return detail::pow2(fractionalBits); }
+
+      /** helper for canConvertToCooked(), overloaded for integer, floating point and other UserTypes */
+      template<typename UserType, typename std::enable_if<std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static constexpr bool rangeFitsInto() {
+        return fractionalBits == 0 &&
+               minRaw() >= static_cast<int64_t>(std::numeric_limits<UserType>::lowest()) &&
+               static_cast<uint64_t>(maxRaw()) <= static_cast<uint64_t>(std::numeric_limits<UserType>::max());
+      }
+      template<typename UserType, typename std::enable_if<std::is_floating_point<UserType>::value, int>::type = 0>
+      static constexpr bool rangeFitsInto() {
+        return coefficient() * minRaw() >= std::numeric_limits<UserType>::lowest() &&
+               coefficient() * maxRaw() <= std::numeric_limits<UserType>::max();
+      }
+      template<typename UserType, typename std::enable_if<!std::is_arithmetic<UserType>::value, int>::type = 0>
+      static constexpr bool rangeFitsInto() {
+        return false;
+      }
+
+      /** minimum and maximum cooked values, saturated to the range of the UserType */
+      template<typename UserType, typename std::enable_if<std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static constexpr UserType minCooked() {
+        return minRaw() < static_cast<int64_t>(std::numeric_limits<UserType>::lowest()) ?
+            std::numeric_limits<UserType>::lowest() : static_cast<UserType>(minRaw());
+      }
+      template<typename UserType, typename std::enable_if<std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static constexpr UserType maxCooked() {
+        return static_cast<uint64_t>(maxRaw()) > static_cast<uint64_t>(std::numeric_limits<UserType>::max()) ?
+            std::numeric_limits<UserType>::max() : static_cast<UserType>(maxRaw());
+      }
+      template<typename UserType, typename std::enable_if<!std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static constexpr UserType minCooked() {
+        return static_cast<UserType>(coefficient() * minRaw());
+      }
+      template<typename UserType, typename std::enable_if<!std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static constexpr UserType maxCooked() {
+        return static_cast<UserType>(coefficient() * maxRaw());
+      }
+
+      /** Crop the unused bits and extend the sign bit (if signed) */
+      static ExtractedType extract(uint32_t rawValue) {
+        return isSignedFlag ? static_cast<ExtractedType>(static_cast<int32_t>(rawValue << (32-nBits)) >> (32-nBits))
+                            : static_cast<ExtractedType>(rawValue & usedBitsMask());
+      }
+
+      template<typename UserType, typename std::enable_if<std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static UserType cook(ExtractedType value) {
+        return static_cast<UserType>(value);
+      }
+      template<typename UserType, typename std::enable_if<!std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static UserType cook(ExtractedType value) {
+        return static_cast<UserType>(coefficient() * static_cast<double>(value));
+      }
+
+      template<typename UserType, typename std::enable_if<std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static uint32_t uncook(UserType value) {
+        return static_cast<uint32_t>(static_cast<int64_t>(value));
+      }
+      template<typename UserType, typename std::enable_if<!std::numeric_limits<UserType>::is_integer, int>::type = 0>
+      static uint32_t uncook(UserType value) {
+        return static_cast<uint32_t>(static_cast<int64_t>(std::round(inverseCoefficient() * static_cast<double>(value))));
+      }
+
+  };
+
+}// namespace ChimeraTK
+
+#endif // CHIMERA_TK_FIXED_POINT_CONVERTER_T_H
@@ -21,7 +21,10 @@ namespace ChimeraTK {
     *
     *  Note that the behaviour is undefined when putting the same TransferElement into the list - a result might
     *  be e.g. that it blocks for ever. This is due to a limitation in the underlying boost::wait_for_any()
-    *  function. */
+    *  function.
+    *
+    *  The cost of each call grows with the number of elements. When waiting repeatedly on the same elements, use a
+    *  ReadAnyGroup instead. */
   ChimeraTK::TransferElementID readAny(std::list<std::reference_wrapper<ChimeraTK::TransferElementAbstractor>> elementsToRead);
   ChimeraTK::TransferElementID readAny(std::list<std::reference_wrapper<ChimeraTK::TransferElement>> elementsToRead);
 
@@ -97,7 +100,7 @@ namespace ChimeraTK {
         // also skip if the future is not yet ready
         if(!future.hasNewData()) continue;
         // compare  version number with the version number of the stored future
-        if(future.getBoostFuture().get()->_versionNumber < theUpdate.getBoostFuture().get()->_versionNumber) {
+        if(future.getVersionNumber() < theUpdate.getVersionNumber()) {
           theUpdate = future;
         }
       }
@@ -0,0 +1,91 @@
+/*
+ * ReadAnyGroup.h
+ */
+
+#ifndef CHIMERATK_READ_ANY_GROUP_H
+#define CHIMERATK_READ_ANY_GROUP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include <boost/lockfree/queue.hpp>
+
+#include "ReadAny.h"
+
+namespace ChimeraTK {
+
+  /** Group of TransferElements to repeatedly wait for new data on any of them. This is equivalent to calling
+   *  readAny() with the same list of elements over and over again, but the elements are registered only once.
+   *  Elements which have completed their transfer notify the group through a lock-free queue, so the cost of each
+   *  readAny() call does not depend on the number of elements in the group.
+   *
+   *  The elements are notified through TransferElement::setReadyListener(). If any element does not support this,
+   *  the group falls back to the plain readAny() function, which visits all elements on each call.
+   *
+   *  While being part of a ReadAnyGroup, the elements must not be read by other means, since a transfer is kept
+   *  running in the background for each element. An element can be part of only one ReadAnyGroup at a time. */
+  class ReadAnyGroup {
+
+    public:
+
+      ReadAnyGroup(std::list<std::reference_wrapper<TransferElementAbstractor>> elements);
+      ReadAnyGroup(std::list<std::reference_wrapper<TransferElement>> elements);
+
+      ReadAnyGroup(const ReadAnyGroup &other) = delete;
+      ReadAnyGroup& operator=(const ReadAnyGroup &other) = delete;
+
+      ~ReadAnyGroup();
+
+      /** Wait until one of the elements has new data and return its ID. The semantics is identical to the readAny()
+       *  function: if several elements have new data, the one with the oldest VersionNumber is chosen. */
+      TransferElementID readAny();
+
+    private:
+
+      /** Register the elements with their listeners, or decide on the fallback mode */
+      void registerListeners();
+
+      /** Called by the elements when their transfer has completed (from any thread) */
+      void notify(size_t index);
+
+      /** Move all tokens from the ready queue into _ready. If none is available and the wait flag is set, block until
+       *  at least one token has arrived. */
+      void collectReady(bool wait);
+
+      struct Element {
+        boost::shared_ptr<TransferElement> element;
+        TransferFuture future;
+      };
+
+      /// The elements of the group
+      std::vector<Element> _elements;
+
+      /// Indices of elements which have notified the group, filled by the listeners
+      boost::lockfree::queue<size_t> _readyQueue;
+
+      /// Indices of elements taken from _readyQueue which have not yet been returned by readAny()
+      std::vector<size_t> _ready;
+
+      /// Flag whether readAsync() has not yet been called on the elements
+      bool _armAll{true};
+
+      /// Index of the element returned by the last call to readAny(), which needs a new readAsync()
+      size_t _rearm{std::numeric_limits<size_t>::max()};
+
+      /// Flag whether all elements support setReadyListener()
+      bool _notificationSupported{true};
+
+      /// Flag whether the consumer is blocked in collectReady(), so the listeners need to wake it up
+      std::atomic<bool> _consumerWaiting{false};
+
+      std::mutex _mutex;
+      std::condition_variable _readyCondition;
+  };
+
+} /* namespace ChimeraTK */
+
+#endif // CHIMERATK_READ_ANY_GROUP_H
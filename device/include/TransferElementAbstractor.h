@@ -114,12 +114,39 @@ namespace ChimeraTK {
        *  Note: This feature is still experimental. Expect API changes without notice! */
       TransferFuture readAsync() { return _implUntyped->readAsync(); }
 
+      /** Return a file descriptor which becomes readable when new data has arrived, see
+       *  TransferElement::getWaitHandle().
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      int getWaitHandle() { return _implUntyped->getWaitHandle(); }
+
+      /** Read data asynchronously and call the handler through the executor once the transfer has completed, see
+       *  TransferElement::readAsync(TransferExecutor, ReadCompletionHandler).
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      void readAsync(TransferExecutor executor, ReadCompletionHandler handler) {
+        _implUntyped->readAsync(std::move(executor), std::move(handler));
+      }
+
+      /** Write data asynchronously and call the handler through the executor once the transfer has completed, see
+       *  TransferElement::writeAsync().
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      void writeAsync(TransferExecutor executor, WriteCompletionHandler handler,
+          ChimeraTK::VersionNumber versionNumber={}) {
+        _implUntyped->writeAsync(std::move(executor), std::move(handler), versionNumber);
+      }
+
       /**
       * Returns the version number that is associated with the last transfer (i.e. last read or write). See
       * ChimeraTK::VersionNumber for details.
       */
       ChimeraTK::VersionNumber getVersionNumber() const { return _implUntyped->getVersionNumber(); }
 
+      /** Returns the number of values which did not fit into the UserType and have been saturated in the last read
+       *  transfer. This is only counted if the accessor was obtained with AccessMode::saturate. */
+      size_t getNumberOfOverflows() const { return _implUntyped->getNumberOfOverflows(); }
+
       /** Write the data to device. The return value is true, old data was lost on the write transfer (e.g. due to an
        *  buffer overflow). In case of an unbuffered write transfer, the return value will always be false. */
       bool write(ChimeraTK::VersionNumber versionNumber={}) { return _implUntyped->write(versionNumber); }
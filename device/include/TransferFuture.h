@@ -13,6 +13,9 @@
 #include <typeinfo>
 #include <list>
 #include <functional>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -46,13 +49,42 @@ namespace ChimeraTK {
     public:
 
       /** Block the current thread until the new data has arrived. The TransferElement::postRead() action is
-       *  automatically executed before returning, so the new data is directly available in the buffer. */
+       *  automatically executed before returning, so the new data is directly available in the buffer. If the
+       *  transfer has failed, the exception is rethrown here. */
       void wait();
 
       /** Check if new data has arrived. If new data has arrived (and thus this function returned true), the user still
        *  has to call wait() to initiate the transfer to the user buffer in the accessor. */
       bool hasNewData();
 
+      /** Check if the transfer has failed with an exception. Must only be called after hasNewData() returned true. */
+      bool hasException();
+
+      /** Return the version number of the transferred data. Must only be called after hasNewData() returned true. If
+       *  the transfer has failed, the exception is rethrown. */
+      VersionNumber getVersionNumber();
+
+      /** Return a file descriptor which becomes readable once hasNewData() would return true. It can be used to wait
+       *  for the transfer with poll(), epoll or the event loop of a framework like boost::asio.
+       *
+       *  The file descriptor belongs to the TransferElement and stays the same for all subsequent transfers, so it
+       *  needs to be registered with the event loop only once. It is reset when the next transfer is started. The
+       *  caller must neither read from nor close it.
+       *
+       *  Returns -1 if the future does not support wait handles (i.e. it was not constructed from a
+       *  ReusablePromise). */
+      int getWaitHandle();
+
+      /** Register a function to be called once the transfer has completed (i.e. once hasNewData() would return
+       *  true). The function is called in the thread completing the transfer, or directly in this function if the
+       *  transfer has already been completed. It must return quickly and must not call wait(); typically it hands
+       *  over to another thread or event loop. Only one continuation can be registered per transfer.
+       *
+       *  If the future was not constructed from a ReusablePromise, a thread of the ReadAsyncThreadPool waits for the
+       *  boost future. Like other blocking waits in the pool, it does not count towards the maximum number of
+       *  threads (see ReadAsyncThreadPool::BlockingSection). */
+      void then(std::function<void()> continuation);
+
       /** Data class for the information transported by the future itself. This class will be extended by backends to
        *  transport additional information, if needed. */
       struct Data {
@@ -71,6 +103,95 @@ namespace ChimeraTK {
       /** Shortcut for the corresponding boost::promise type. */
       typedef boost::promise<Data*> PromiseType;
 
+      /** Lightweight promise which can be reused for subsequent transfers without any allocation. It is owned by the
+       *  TransferElement and must be re-armed with reset() before each transfer. The TransferFuture only keeps a
+       *  pointer to it, so like for the TransferElement itself it must not be destroyed while a TransferFuture is in
+       *  use. Since the state is reused, a TransferFuture from a previous transfer must not be used any more once the
+       *  promise has been re-armed.
+       *
+       *  Checking for completion is a single atomic load, blocking uses a futex on Linux and a condition variable on
+       *  other platforms. A boost::shared_future is only created if TransferFuture::getBoostFuture() is called for
+       *  the current transfer. */
+      class ReusablePromise {
+        public:
+          ReusablePromise() = default;
+          ReusablePromise(const ReusablePromise &other) = delete;
+          ReusablePromise& operator=(const ReusablePromise &other) = delete;
+          ~ReusablePromise();
+
+          /** Re-arm the promise for the next transfer. Must not be called while a thread waits on it. */
+          void reset();
+
+          /** Fulfil the promise and wake up all waiting threads. */
+          void setValue(Data *data);
+
+          /** Fulfil the promise with an exception and wake up all waiting threads. */
+          void setException(boost::exception_ptr exception);
+
+          /** Check whether the promise has been fulfilled (either with a value or an exception). */
+          bool isReady() const { return _state.load(std::memory_order_acquire) == ready; }
+
+          /** Block until the promise has been fulfilled. */
+          void wait();
+
+          /** Check whether the promise has been fulfilled with an exception. Must only be called if isReady(). */
+          bool hasException() const { return bool(_exception); }
+
+          /** Return the data passed to setValue(). Must only be called if isReady() and not hasException(). */
+          Data* getData() const { return _data; }
+
+          /** Return a file descriptor which is readable while the promise is fulfilled, see
+           *  TransferFuture::getWaitHandle(). It is an eventfd on Linux and the read end of a pipe on other platforms,
+           *  created on the first call. */
+          int getWaitHandle();
+
+          /** Register a function to be called when the promise is fulfilled, see TransferFuture::then(). */
+          void then(std::function<void()> continuation);
+
+        private:
+          friend class TransferFuture;
+
+          /** Wake up waiting threads and fulfil the boost promise, if one was requested */
+          void complete();
+
+          /** Return the boost future for the current transfer, create it if needed */
+          PlainFutureType getBoostFuture();
+
+          /** Fulfil the boost promise if not yet done. Must be called with _compatMutex held. */
+          void completeCompatPromise();
+
+          /// Values of _state. The value is used as a futex word on Linux.
+          enum : uint32_t { pending = 0, pendingWithWaiters = 1, ready = 2 };
+
+          std::atomic<uint32_t> _state{pending};
+          Data *_data{nullptr};
+          boost::exception_ptr _exception;
+
+          /// boost promise/future pair created by getBoostFuture(), for compatibility with the boost interface
+          bool _compatRequested{false};
+          bool _compatCompleted{false};
+          PromiseType _compatPromise;
+          PlainFutureType _compatFuture;
+
+          /// file descriptor returned by getWaitHandle(), -1 if not yet requested
+          int _waitHandle{-1};
+
+          /// file descriptor to make _waitHandle readable: the same eventfd on Linux, the write end of the pipe else
+          int _waitHandleWriteEnd{-1};
+
+          /// Function registered with then() for the current transfer
+          std::function<void()> _continuation;
+
+          /// Mutex protecting the boost promise/future pair, the wait handle and the continuation, also held in reset()
+          /// and while completing
+          std::mutex _compatMutex;
+
+#ifndef __linux__
+          /// Notified by complete() if a thread is waiting, used together with _compatMutex where no futex exists
+          std::condition_variable _stateChanged;
+#endif
+      };
+
       /** Default constructor to generate a dysfunctional future. To initialise the future properly, reset() must be
        *  called afterwards. This pattern is used since the TransferFuture is a member of the TransferElement and only
        *  references are returned by readAsync(). */
@@ -81,15 +202,19 @@ namespace ChimeraTK {
       TransferFuture(PlainFutureType plainFuture, ChimeraTK::TransferElement *transferElement)
       : _theFuture(plainFuture), _transferElement(transferElement) {}
 
+      /** Construct from a ReusablePromise. The promise must have been re-armed with reset() before. */
+      TransferFuture(ReusablePromise &promise, ChimeraTK::TransferElement *transferElement)
+      : _transferElement(transferElement), _promise(&promise) {}
+
       /** "Decorating copy constructor": copy from other TransferFuture but override the transfer element. The
        *  typical use case is a decorating TransferElement. */
       TransferFuture(const TransferFuture &other, ChimeraTK::TransferElement *transferElement)
-      : _theFuture(other._theFuture), _transferElement(transferElement) {}
+      : _theFuture(other._theFuture), _transferElement(transferElement), _promise(other._promise) {}
 
       /** "Decorating move constructor": move from other TransferFuture but override the transfer element. The
        *  typical use case is a decorating TransferElement. */
       TransferFuture(TransferFuture &&other, ChimeraTK::TransferElement *transferElement)
-      : _theFuture(std::move(other._theFuture)), _transferElement(transferElement) {}
+      : _theFuture(std::move(other._theFuture)), _transferElement(transferElement), _promise(other._promise) {}
 
       /** Copy constructor */
       TransferFuture(const TransferFuture &) = default;
@@ -116,8 +241,14 @@ namespace ChimeraTK {
 
       /** Return the underlying BOOST future. Be careful when using it. Simply waiting on that future is not sufficient
        *  since the very purpose of this class is to add functionality. Always call TransferFuture::wait() before
-       *  accessing the TransferElement again! */
-      PlainFutureType& getBoostFuture() { return _theFuture; }
+       *  accessing the TransferElement again!
+       *
+       *  If the future was constructed from a ReusablePromise, the boost future is created on the first call for each
+       *  transfer. Prefer the other member functions, which do not need it. */
+      PlainFutureType& getBoostFuture() {
+        if(_promise) _theFuture = _promise->getBoostFuture();
+        return _theFuture;
+      }
 
     protected:
 
@@ -126,6 +257,9 @@ namespace ChimeraTK {
 
       /** Pointer to the TransferElement */
       ChimeraTK::TransferElement *_transferElement;
+
+      /** Pointer to the ReusablePromise, if constructed from one. Otherwise _theFuture is used. */
+      ReusablePromise *_promise{nullptr};
   };
 
 } /* namespace ChimeraTK */
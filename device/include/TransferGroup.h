@@ -9,11 +9,18 @@
 #define CHIMERA_TK_TRANSFER_GROUP_H
 
 #include <set>
+#include <map>
+#include <vector>
+#include <iostream>
 
 #include "TransferElementAbstractor.h"
 
 namespace ChimeraTK {
 
+  class DeviceBackend;
+  class NumericAddressedBackend;
+  class NumericAddressedLowLevelTransferElement;
+
   /** Group multiple data accessors to efficiently trigger data transfers on the whole group. In case of some backends
    *  like the LogicalNameMappingBackend, grouping data accessors can avoid unnecessary transfers of the same data.
    *  This happens in particular, if accessing the data of one accessor requires transfer of a bigger block of
@@ -37,7 +44,7 @@ namespace ChimeraTK {
     public:
 
       TransferGroup()
-      : readOnly(false)
+      : readOnly(false), maxMergeGap(0), parallelTransfers(false)
       {};
       ~TransferGroup() {};
 
@@ -57,15 +64,48 @@ namespace ChimeraTK {
        *  elements is read-only. */
       bool isReadOnly();
 
+      /** Set the maximum gap in bytes between two registers of the same NumericAddressedBackend and bar, which still
+       *  allows merging their transfers into a single transfer. The default is 0, i.e. only adjacent or overlapping
+       *  registers are merged. A larger gap reduces the number of transfers, which is worth it for backends with a high
+       *  latency per transfer (e.g. Rebot or PCIe). The words in the gap are read (so do not use this if reading a
+       *  register in the gap has side effects), but they are never written.
+       *
+       *  Only affects accessors added after calling this function. */
+      void setMaxMergeGap(size_t maxMergeGapInBytes);
+
+      /** Enable or disable running the transfers of different backends concurrently in read() and write(). This
+       *  reduces the latency of groups spanning multiple devices (e.g. several Rebot boards) to the latency of the
+       *  slowest device instead of the sum of all. Each backend is transferred in a separate thread, so this only pays
+       *  off if the transfers take longer than starting a thread. The order of the preRead()/postRead() resp.
+       *  preWrite()/postWrite() calls is not affected. Disabled by default.
+       *
+       *  All transfers of one backend are done in the same thread in the same order as without this option: first
+       *  the elements which cannot be merged into NumericAddressedBackend::readv() resp. writev() (e.g. multiplexed 2D
+       *  registers) one by one, then the merged ranges. Note that this means such elements are written before the
+       *  other registers of the same backend, regardless of the order in which the accessors have been added. */
+      void setParallelTransfers(bool enable);
+
       /** Print information about the accessors in this group to screen, which might help to understand which
-       *  transfers were merged and which were not. */
-      void dump();
+       *  transfers were merged and which were not. This includes the resulting transfer plan per backend. */
+      void dump(std::ostream &stream = std::cout);
 
     protected:
 
       /** List of low-level TransferElements in this group, which are directly responsible for the hardware access */
       std::set< boost::shared_ptr<TransferElement> > lowLevelElements;
 
+      /** The low-level elements accessing one backend. The other elements are transferred one by one, followed by a
+       *  single call to NumericAddressedBackend::readv() resp. writev() for the numeric-addressed elements. */
+      struct BackendTransfers {
+        boost::shared_ptr<NumericAddressedBackend> numericAddressedBackend;
+        std::vector< boost::shared_ptr<NumericAddressedLowLevelTransferElement> > numericAddressedElements;
+        std::vector< boost::shared_ptr<TransferElement> > otherElements;
+      };
+
+      /** The low-level elements sorted by the backend they access (see TransferElement::getTransferBackend()).
+       *  Elements which do not know their backend are stored under nullptr and are treated like one backend. */
+      std::map< const DeviceBackend*, BackendTransfers > transfersByBackend;
+
       /** List of all CopyRegisterDecorators in the group. On these elements, postRead() has to be executed before all
        *  other elements. */
       std::set< boost::shared_ptr<TransferElement> > copyDecorators;
@@ -75,6 +115,15 @@ namespace ChimeraTK {
 
       /** Flag if group is read-only */
       bool readOnly;
+
+      /** Maximum gap in bytes for merging transfers, see setMaxMergeGap() */
+      size_t maxMergeGap;
+
+      /** Flag whether the transfers of different backends are run concurrently, see setParallelTransfers() */
+      bool parallelTransfers;
+
+      /** Execute the transfers of all low-level elements, either sequentially or one thread per backend */
+      void runLowLevelTransfers(bool isWrite);
   };
 
 } /* namespace ChimeraTK */
@@ -1,13 +1,65 @@
+#include <boost/make_shared.hpp>
+
 #include "FixedPointConverter.h"
 #include "DeviceException.h"
 
 namespace ChimeraTK {
 
   const int FixedPointConverter::zero = 0;
+  constexpr unsigned int FixedPointConverter::maxLookupTableBits;
+
+  /**********************************************************************************************************************/
+
+  class FixedPointConverter::selectKernels {
+    public:
+      selectKernels(FixedPointConverter *fpc): _fpc(fpc) {}
+
+      template <typename Pair>
+      void operator()(Pair) const
+      {
+        // obtain UserType from given fusion::pair type
+        typedef typename Pair::first_type UserType;
+
+        // Commonly used register layouts, for which compile-time specialised kernels are available. If the layout
+        // is not in this list, the kernels are set to nullptr and the generic implementation is used.
+        select<UserType, 32,0,true>() || select<UserType, 32,0,false>() ||
+        select<UserType, 24,0,true>() || select<UserType, 24,0,false>() ||
+        select<UserType, 18,0,true>() || select<UserType, 18,16,true>() || select<UserType, 18,17,true>() ||
+        select<UserType, 16,0,true>() || select<UserType, 16,0,false>() || select<UserType, 16,15,true>() ||
+        select<UserType, 12,0,true>() || select<UserType, 12,0,false>() ||
+        select<UserType, 8,0,true>() || select<UserType, 8,0,false>() ||
+        select<UserType, 1,0,false>() || clear<UserType>();
+      }
+
+    private:
+
+      template<typename UserType, unsigned int nBits, int fractionalBits, bool isSignedFlag>
+      bool select() const {
+        if(_fpc->_nBits != nBits || _fpc->_fractionalBits != fractionalBits || _fpc->_isSigned != isSignedFlag) {
+          return false;
+        }
+        typedef FixedPointConverterT<nBits, fractionalBits, isSignedFlag> Kernels;
+        boost::fusion::at_key<UserType>(_fpc->_toCookedKernels.table) = Kernels::template getToCookedKernel<UserType>();
+        boost::fusion::at_key<UserType>(_fpc->_toRawKernels.table) = Kernels::template getToRawKernel<UserType>();
+        return true;
+      }
+
+      template<typename UserType>
+      bool clear() const {
+        boost::fusion::at_key<UserType>(_fpc->_toCookedKernels.table) = nullptr;
+        boost::fusion::at_key<UserType>(_fpc->_toRawKernels.table) = nullptr;
+        return true;
+      }
+
+      FixedPointConverter *_fpc;
+  };
+
+  /**********************************************************************************************************************/
 
   FixedPointConverter::FixedPointConverter(std::string variableName, unsigned int nBits, int fractionalBits, bool isSignedFlag)
     : _variableName(variableName), _nBits(nBits), _fractionalBits(fractionalBits), _isSigned(isSignedFlag),
-    _fractionalBitsCoefficient(pow(2.,-fractionalBits)), _inverseFractionalBitsCoefficient(pow(2.,fractionalBits))
+    _fractionalBitsCoefficient(pow(2.,-fractionalBits)), _inverseFractionalBitsCoefficient(pow(2.,fractionalBits)),
+    _useLookupTable(false)
   {
     reconfigure(nBits,fractionalBits,isSignedFlag);
   }
@@ -62,6 +114,77 @@ namespace ChimeraTK {
     // note: we loop over one of the maps only, but initCoefficients() will fill all maps!
     boost::fusion::for_each(_minCookedValues, initCoefficients(this));
 
+    // select compile-time specialised conversion kernels, if available for this configuration
+    boost::fusion::for_each(_toCookedKernels.table, selectKernels(this));
+
+    // obtain the lookup tables for the new configuration, if enabled
+    updateLookupTables();
+
+  }
+
+  /**********************************************************************************************************************/
+
+  void FixedPointConverter::enableLookupTable() {
+    _useLookupTable = true;
+    updateLookupTables();
+  }
+
+  /**********************************************************************************************************************/
+
+  namespace {
+
+    /// helper class to create empty lookup tables for all numeric UserTypes. The tables are filled on first use.
+    class createLookupTables {
+      public:
+        createLookupTables(TemplateUserTypeMap<FixedPointLookupTablePtr> &tables): _tables(tables) {}
+
+        template <typename Pair>
+        void operator()(Pair) const
+        {
+          // obtain UserType from given fusion::pair type
+          typedef typename Pair::first_type UserType;
+          if(std::is_arithmetic<UserType>::value) {
+            boost::fusion::at_key<UserType>(_tables.table) = boost::make_shared<FixedPointLookupTable<UserType>>();
+          }
+        }
+
+      private:
+        TemplateUserTypeMap<FixedPointLookupTablePtr> &_tables;
+    };
+
+    /// global registry of the lookup tables, so they are shared between all converters with the same configuration
+    struct LookupTableRegistry {
+      std::mutex mutex;
+      std::vector< std::pair< FixedPointConverter, TemplateUserTypeMap<FixedPointLookupTablePtr> > > entries;
+    };
+
+    LookupTableRegistry& getLookupTableRegistry() {
+      static LookupTableRegistry registry;
+      return registry;
+    }
+
+  }
+
+  /**********************************************************************************************************************/
+
+  void FixedPointConverter::updateLookupTables() {
+    if(!_useLookupTable || _nBits > maxLookupTableBits) {
+      _lookupTables = TemplateUserTypeMap<FixedPointLookupTablePtr>();
+      return;
+    }
+
+    auto &registry = getLookupTableRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(auto &entry : registry.entries) {
+      if(entry.first == *this) {
+        _lookupTables = entry.second;
+        return;
+      }
+    }
+    _lookupTables = TemplateUserTypeMap<FixedPointLookupTablePtr>();
+    boost::fusion::for_each(_lookupTables.table, createLookupTables(_lookupTables));
+    registry.entries.emplace_back(FixedPointConverter("lookupTableRegistry", _nBits, _fractionalBits, _isSigned),
+                                  _lookupTables);
   }
 
   /**********************************************************************************************************************/
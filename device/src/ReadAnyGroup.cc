@@ -0,0 +1,142 @@
+/*
+ * ReadAnyGroup.cc
+ */
+
+#include <algorithm>
+
+#include "ReadAnyGroup.h"
+#include "TransferElementAbstractor.h"
+#include "DeviceException.h"
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  ReadAnyGroup::ReadAnyGroup(std::list<std::reference_wrapper<TransferElementAbstractor>> elements)
+  : _readyQueue(2*elements.size())
+  {
+    for(auto &elem : elements) _elements.push_back({elem.get().getHighLevelImplElement(), {}});
+    registerListeners();
+  }
+
+  /*********************************************************************************************************************/
+
+  ReadAnyGroup::ReadAnyGroup(std::list<std::reference_wrapper<TransferElement>> elements)
+  : _readyQueue(2*elements.size())
+  {
+    for(auto &elem : elements) _elements.push_back({elem.get().getHighLevelImplElement(), {}});
+    registerListeners();
+  }
+
+  /*********************************************************************************************************************/
+
+  ReadAnyGroup::~ReadAnyGroup() {
+    if(!_notificationSupported) return;
+    // after setReadyListener() has returned, no listener will access this object any more
+    for(auto &elem : _elements) elem.element->setReadyListener({});
+  }
+
+  /*********************************************************************************************************************/
+
+  void ReadAnyGroup::registerListeners() {
+    if(_elements.empty()) {
+      throw DeviceException("A ReadAnyGroup needs at least one element.", DeviceException::WRONG_PARAMETER);
+    }
+    for(size_t i = 0; i < _elements.size(); ++i) {
+      if(!_elements[i].element->setReadyListener([this, i] { notify(i); })) {
+        // fall back to the plain readAny() for the entire group
+        _notificationSupported = false;
+        for(size_t k = 0; k < i; ++k) _elements[k].element->setReadyListener({});
+        return;
+      }
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void ReadAnyGroup::notify(size_t index) {
+    _readyQueue.push(index);
+    if(_consumerWaiting) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _readyCondition.notify_one();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void ReadAnyGroup::collectReady(bool wait) {
+    auto takeToken = [this](size_t index) {
+      if(std::find(_ready.begin(), _ready.end(), index) == _ready.end()) _ready.push_back(index);
+    };
+    if(_readyQueue.consume_all(takeToken) > 0 || !wait) return;
+
+    // Block until a token arrives. _consumerWaiting is set before checking the queue again, so a listener either
+    // sees the flag and wakes us up, or its token is found by the check.
+    std::unique_lock<std::mutex> lock(_mutex);
+    _consumerWaiting = true;
+    while(_readyQueue.consume_all(takeToken) == 0) {
+      _readyCondition.wait(lock);
+    }
+    _consumerWaiting = false;
+  }
+
+  /*********************************************************************************************************************/
+
+  TransferElementID ReadAnyGroup::readAny() {
+    if(!_notificationSupported) {
+      std::list<std::reference_wrapper<TransferElement>> elementList;
+      for(auto &elem : _elements) elementList.push_back(*elem.element);
+      return detail::readAny(elementList);
+    }
+
+    // start the transfers which are not yet running
+    if(_armAll) {
+      for(size_t i = 0; i < _elements.size(); ++i) {
+        _elements[i].future = _elements[i].element->readAsync();
+        // the transfer might have been completed before the listener was registered
+        if(_elements[i].future.hasNewData()) notify(i);
+      }
+      _armAll = false;
+    }
+    else if(_rearm < _elements.size()) {
+      _elements[_rearm].future = _elements[_rearm].element->readAsync();
+    }
+
+    while(true) {
+      collectReady(_ready.empty());
+
+      // Find the ready element with the oldest version number. Tokens are only hints: an element might have been
+      // notified more than once, so it is checked whether the current transfer of the element is really complete.
+      auto theUpdate = _ready.end();
+      for(auto it = _ready.begin(); it != _ready.end();) {
+        auto &future = _elements[*it].future;
+        if(!future.hasNewData()) {
+          it = _ready.erase(it);
+          continue;
+        }
+        // an exception is reported immediately
+        if(future.hasException()) {
+          theUpdate = it;
+          break;
+        }
+        if(theUpdate == _ready.end() ||
+           future.getVersionNumber() < _elements[*theUpdate].future.getVersionNumber()) {
+          theUpdate = it;
+        }
+        ++it;
+      }
+      if(theUpdate == _ready.end()) continue;
+
+      size_t index = *theUpdate;
+      _ready.erase(theUpdate);
+      _rearm = index;
+
+      // complete the transfer (i.e. run postRead())
+      _elements[index].future.wait();
+      return _elements[index].element->getId();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+} /* namespace ChimeraTK */
@@ -6,9 +6,62 @@
  */
 
 #include "TransferElement.h"
+#include "ReadAsyncThreadPool.h"
 
 namespace ChimeraTK {
 
   constexpr char TransferElement::unitNotSet[];
 
+  /*********************************************************************************************************************/
+
+  void TransferElement::readAsync(TransferExecutor executor, ReadCompletionHandler handler) {
+    TransferFuture future = readAsync();
+    // Only a weak pointer is kept until the transfer has completed. A transfer which never completes (e.g. waiting
+    // for data which does not arrive) would otherwise keep the TransferElement alive for ever.
+    boost::weak_ptr<TransferElement> weakSelf = shared_from_this();
+    future.then([weakSelf, future, executor, handler] {
+      executor([weakSelf, future, handler]() mutable {
+        auto self = weakSelf.lock();
+        if(!self) return;
+        boost::exception_ptr exception;
+        try {
+          future.wait();
+        }
+        catch(...) {
+          exception = boost::current_exception();
+        }
+        handler(exception);
+      });
+    });
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferElement::writeAsync(TransferExecutor executor, WriteCompletionHandler handler,
+      ChimeraTK::VersionNumber versionNumber) {
+    if(isInTransferGroup) {
+      throw DeviceException("Calling read() or write() on an accessor which is part of a TransferGroup is not allowed.",
+          DeviceException::NOT_IMPLEMENTED);
+    }
+    writeTransactionInProgress = false;
+    preWrite();
+    auto self = shared_from_this();
+    ReadAsyncThreadPool::getInstance().post([self, executor, handler, versionNumber] {
+      bool dataLost = false;
+      boost::exception_ptr exception;
+      try {
+        dataLost = self->doWriteTransfer(versionNumber);
+      }
+      catch(...) {
+        exception = boost::current_exception();
+      }
+      executor([self, handler, dataLost, exception] {
+        self->postWrite();
+        handler(dataLost, exception);
+      });
+    });
+  }
+
+  /*********************************************************************************************************************/
+
 }
@@ -1,24 +1,294 @@
 #include "TransferFuture.h"
 #include "TransferElement.h"
+#include "ReadAsyncThreadPool.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#else
+#include <fcntl.h>
+#endif
 
 #include <boost/ratio.hpp>
 #include <boost/chrono.hpp>
 
 namespace ChimeraTK {
 
+#ifdef __linux__
+  namespace {
+
+    // std::atomic<uint32_t> has the same representation as uint32_t on Linux, so it can be used as a futex word.
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "std::atomic<uint32_t> cannot be used as futex");
+
+    void futexWait(std::atomic<uint32_t> &word, uint32_t expectedValue) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expectedValue, nullptr, nullptr, 0);
+    }
+
+    void futexWakeAll(std::atomic<uint32_t> &word) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+  }
+#endif
+
+  namespace {
+
+    // The wait handle is an eventfd on Linux. Other platforms use a pipe, which is readable while it contains data.
+    // Both ends are non-blocking, so clearing an empty handle or signalling a full pipe does not block.
+
+    /** Create the wait handle and return the file descriptor to be polled. writeEnd is set to the file descriptor
+     *  which makes it readable. Returns -1 on failure. */
+    int openWaitHandle(int &writeEnd) {
+#ifdef __linux__
+      writeEnd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      return writeEnd;
+#else
+      int ends[2];
+      if(pipe(ends) != 0) return -1;
+      for(int end : ends) {
+        fcntl(end, F_SETFL, fcntl(end, F_GETFL) | O_NONBLOCK);
+        fcntl(end, F_SETFD, FD_CLOEXEC);
+      }
+      writeEnd = ends[1];
+      return ends[0];
+#endif
+    }
+
+    void signalWaitHandle(int writeEnd) {
+#ifdef __linux__
+      eventfd_write(writeEnd, 1);
+#else
+      // a failed write leaves a full pipe, which is readable anyway
+      char byte = 1;
+      if(write(writeEnd, &byte, 1) < 0) return;
+#endif
+    }
+
+    void clearWaitHandle(int readEnd) {
+#ifdef __linux__
+      eventfd_t value;
+      eventfd_read(readEnd, &value);
+#else
+      char bytes[16];
+      while(read(readEnd, bytes, sizeof(bytes)) > 0) {}
+#endif
+    }
+
+  }
+
+  /*********************************************************************************************************************/
+
   void TransferFuture::wait() {
     _transferElement->transferFutureWaitCallback();
+    if(_promise) {
+      _promise->wait();
+      _transferElement->postRead();
+      // rethrow an exception which occurred during the transfer
+      if(_promise->hasException()) boost::rethrow_exception(_promise->_exception);
+      return;
+    }
     _theFuture.wait();
     _transferElement->postRead();
+    // rethrow an exception which occurred during the transfer
+    if(_theFuture.has_exception()) _theFuture.get();
   }
 
+  /*********************************************************************************************************************/
+
   bool TransferFuture::hasNewData() {
+    if(_promise) return _promise->isReady();
     auto status = _theFuture.wait_for(boost::chrono::duration<int, boost::centi>(0));
     return (status != boost::future_status::timeout);
   }
 
+  /*********************************************************************************************************************/
+
+  bool TransferFuture::hasException() {
+    if(_promise) return _promise->hasException();
+    return _theFuture.has_exception();
+  }
+
+  /*********************************************************************************************************************/
+
+  VersionNumber TransferFuture::getVersionNumber() {
+    if(_promise) {
+      if(_promise->hasException()) boost::rethrow_exception(_promise->_exception);
+      return _promise->getData()->_versionNumber;
+    }
+    return _theFuture.get()->_versionNumber;
+  }
+
+  /*********************************************************************************************************************/
+
+  int TransferFuture::getWaitHandle() {
+    if(_promise) return _promise->getWaitHandle();
+    return -1;
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::then(std::function<void()> continuation) {
+    if(_promise) {
+      _promise->then(std::move(continuation));
+      return;
+    }
+    PlainFutureType theFuture = _theFuture;
+    ReadAsyncThreadPool::getInstance().post([theFuture, continuation]() mutable {
+      {
+        // the wait must not occupy one of the limited threads of the pool
+        ReadAsyncThreadPool::BlockingSection blocking;
+        theFuture.wait();
+      }
+      continuation();
+    });
+  }
+
+  /*********************************************************************************************************************/
+
   ChimeraTK::TransferElementID TransferFuture::getTransferElementID() {
     return _transferElement->getId();
   }
 
+  /*********************************************************************************************************************/
+
+  TransferFuture::ReusablePromise::~ReusablePromise() {
+    if(_waitHandle >= 0) close(_waitHandle);
+    if(_waitHandleWriteEnd >= 0 && _waitHandleWriteEnd != _waitHandle) close(_waitHandleWriteEnd);
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::reset() {
+    std::lock_guard<std::mutex> lock(_compatMutex);
+    _data = nullptr;
+    _exception = boost::exception_ptr();
+    if(_compatRequested) {
+      _compatRequested = false;
+      _compatCompleted = false;
+      _compatPromise = PromiseType();
+      _compatFuture = PlainFutureType();
+    }
+    _continuation = nullptr;
+    if(_waitHandle >= 0) clearWaitHandle(_waitHandle);
+    _state.store(pending, std::memory_order_release);
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::setValue(Data *data) {
+    _data = data;
+    complete();
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::setException(boost::exception_ptr exception) {
+    _exception = exception;
+    complete();
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::complete() {
+    uint32_t previousState;
+    std::function<void()> continuation;
+    {
+      // The mutex is held while publishing the state, so a concurrent getBoostFuture() is either seen here or sees
+      // the ready state, and the next reset() cannot interfere with completing the boost promise.
+      std::lock_guard<std::mutex> lock(_compatMutex);
+      previousState = _state.exchange(ready);
+      if(_compatRequested) completeCompatPromise();
+      if(_waitHandle >= 0) signalWaitHandle(_waitHandleWriteEnd);
+      continuation.swap(_continuation);
+    }
+    if(previousState == pendingWithWaiters) {
+#ifdef __linux__
+      futexWakeAll(_state);
+#else
+      // The state has been changed with the mutex held, so a waiter either sees it or is already waiting.
+      _stateChanged.notify_all();
+#endif
+    }
+    if(continuation) continuation();
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::wait() {
+    uint32_t state = _state.load(std::memory_order_acquire);
+    while(state != ready) {
+      if(state == pending) {
+        // announce the waiter, so complete() issues the wake-up call
+        if(!_state.compare_exchange_weak(state, pendingWithWaiters)) continue;
+      }
+#ifdef __linux__
+      futexWait(_state, pendingWithWaiters);
+#else
+      {
+        std::unique_lock<std::mutex> lock(_compatMutex);
+        _stateChanged.wait(lock, [this] { return _state.load(std::memory_order_acquire) != pendingWithWaiters; });
+      }
+#endif
+      state = _state.load(std::memory_order_acquire);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  TransferFuture::PlainFutureType TransferFuture::ReusablePromise::getBoostFuture() {
+    std::lock_guard<std::mutex> lock(_compatMutex);
+    if(!_compatRequested) {
+      _compatFuture = _compatPromise.get_future().share();
+      _compatRequested = true;
+      if(isReady()) completeCompatPromise();
+    }
+    return _compatFuture;
+  }
+
+  /*********************************************************************************************************************/
+
+  int TransferFuture::ReusablePromise::getWaitHandle() {
+    std::lock_guard<std::mutex> lock(_compatMutex);
+    if(_waitHandle < 0) {
+      _waitHandle = openWaitHandle(_waitHandleWriteEnd);
+      if(_waitHandle < 0) {
+        throw DeviceException(std::string("Cannot create wait handle: ") + strerror(errno),
+            DeviceException::NOT_AVAILABLE);
+      }
+      if(isReady()) signalWaitHandle(_waitHandleWriteEnd);
+    }
+    return _waitHandle;
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::then(std::function<void()> continuation) {
+    {
+      std::lock_guard<std::mutex> lock(_compatMutex);
+      if(!isReady()) {
+        _continuation = std::move(continuation);
+        return;
+      }
+    }
+    continuation();
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferFuture::ReusablePromise::completeCompatPromise() {
+    if(_compatCompleted) return;
+    if(_exception) {
+      _compatPromise.set_exception(_exception);
+    }
+    else {
+      _compatPromise.set_value(_data);
+    }
+    _compatCompleted = true;
+  }
+
 }
@@ -5,12 +5,16 @@
  *      Author: Martin Hierholzer
  */
 
+#include <future>
+#include <iterator>
+
 #include "TransferGroup.h"
 #include "TransferElementAbstractor.h"
 #include "DeviceException.h"
 #include "NDRegisterAccessorAbstractor.h"
 #include "NDRegisterAccessorDecorator.h"
 #include "CopyRegisterDecorator.h"
+#include "NumericAddressedLowLevelTransferElement.h"
 
 namespace ChimeraTK {
 
@@ -20,9 +24,7 @@ namespace ChimeraTK {
     for(auto &elem : highLevelElements) {
       elem->preRead();
     }
-    for(auto &elem : lowLevelElements) {
-      elem->doReadTransfer();
-    }
+    runLowLevelTransfers(false);
     for(auto &elem : copyDecorators) {
       elem->postRead();
     }
@@ -41,9 +43,7 @@ namespace ChimeraTK {
     for(auto &elem : highLevelElements) {
       elem->preWrite();
     }
-    for(auto &elem : lowLevelElements) {
-      elem->doWriteTransfer();
-    }
+    runLowLevelTransfers(true);
     for(auto &elem : highLevelElements) {
       elem->postWrite();
     }
@@ -51,6 +51,75 @@ namespace ChimeraTK {
 
   /*********************************************************************************************************************/
 
+  void TransferGroup::runLowLevelTransfers(bool isWrite) {
+
+    // transfer all elements of one backend: the ones which cannot be merged one by one, then all numeric-addressed
+    // elements with a single call
+    auto transferBackend = [isWrite](const BackendTransfers &transfers) {
+      for(auto &elem : transfers.otherElements) {
+        if(isWrite) {
+          elem->doWriteTransfer();
+        }
+        else {
+          elem->doReadTransfer();
+        }
+      }
+      if(transfers.numericAddressedElements.empty()) return;
+      std::vector<NumericAddressedBackend::TransferRange> ranges;
+      for(auto &elem : transfers.numericAddressedElements) {
+        if(isWrite) {
+          elem->appendWriteTransferRanges(ranges);
+        }
+        else {
+          ranges.push_back(elem->getTransferRange());
+        }
+      }
+      if(isWrite) {
+        transfers.numericAddressedBackend->writev(ranges);
+      }
+      else {
+        transfers.numericAddressedBackend->readv(ranges);
+      }
+    };
+
+    if(!parallelTransfers || transfersByBackend.size() < 2) {
+      for(auto &backendAndTransfers : transfersByBackend) transferBackend(backendAndTransfers.second);
+      return;
+    }
+
+    // launch one task per backend, except for the first one which is transferred meanwhile in this thread
+    std::vector< std::future<void> > tasks;
+    for(auto it = std::next(transfersByBackend.begin()); it != transfersByBackend.end(); ++it) {
+      tasks.push_back(std::async(std::launch::async, transferBackend, std::cref(it->second)));
+    }
+    std::exception_ptr firstException;
+    try {
+      transferBackend(transfersByBackend.begin()->second);
+    }
+    catch(...) {
+      firstException = std::current_exception();
+    }
+
+    // always wait for all tasks before returning, even if one of them failed
+    for(auto &task : tasks) {
+      try {
+        task.get();
+      }
+      catch(...) {
+        if(!firstException) firstException = std::current_exception();
+      }
+    }
+    if(firstException) std::rethrow_exception(firstException);
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferGroup::setParallelTransfers(bool enable) {
+    parallelTransfers = enable;
+  }
+
+  /*********************************************************************************************************************/
+
   bool TransferGroup::isReadOnly() {
     return readOnly;
   }
@@ -65,9 +134,25 @@ namespace ChimeraTK {
           DeviceException::WRONG_PARAMETER);
     }
 
+    // the group reads the hardware-accessing elements directly, so it cannot wait for new data
+    auto elements = accessor.getHighLevelImplElement()->getInternalElements();
+    elements.push_front(accessor.getHighLevelImplElement());
+    for(auto &elem : elements) {
+      if(elem->isWaitingForNewData()) {
+        throw DeviceException("Accessors with AccessMode::wait_for_new_data cannot be added to a TransferGroup.",
+            DeviceException::WRONG_PARAMETER);
+      }
+    }
+
     // set flag on the accessors that it is now in a transfer group
     accessor.getHighLevelImplElement()->isInTransferGroup = true;
 
+    // configure the merging of the new accessor's low-level elements
+    for(auto &hwElem : accessor.getHighLevelImplElement()->getHardwareAccessingElements()) {
+      auto numericAddressedElement = boost::dynamic_pointer_cast<NumericAddressedLowLevelTransferElement>(hwElem);
+      if(numericAddressedElement) numericAddressedElement->setMaxMergeGap(maxMergeGap);
+    }
+
     auto highLevelElementsWithNewAccessor = highLevelElements;
     highLevelElementsWithNewAccessor.insert(accessor.getHighLevelImplElement());
 
@@ -98,6 +183,21 @@ namespace ChimeraTK {
       for(auto &hwElem : hlElem->getHardwareAccessingElements()) lowLevelElements.insert(hwElem);
     }
 
+    // sort the low-level elements by backend, so the numeric-addressed ones can be transferred in one go and the
+    // transfers of each backend stay in the same thread
+    transfersByBackend.clear();
+    for(auto &llElem : lowLevelElements) {
+      auto &transfers = transfersByBackend[llElem->getTransferBackend()];
+      auto numericAddressedElement = boost::dynamic_pointer_cast<NumericAddressedLowLevelTransferElement>(llElem);
+      if(numericAddressedElement) {
+        transfers.numericAddressedBackend = numericAddressedElement->getBackend();
+        transfers.numericAddressedElements.push_back(numericAddressedElement);
+      }
+      else {
+        transfers.otherElements.push_back(llElem);
+      }
+    }
+
     // update the list of CopyRegisterDecorators
     copyDecorators.clear();
     for(auto &hlElem : highLevelElements) {
@@ -139,17 +239,49 @@ namespace ChimeraTK {
 
   /*********************************************************************************************************************/
 
-  void TransferGroup::dump() {
+  void TransferGroup::setMaxMergeGap(size_t maxMergeGapInBytes) {
+    maxMergeGap = maxMergeGapInBytes;
+  }
+
+  /*********************************************************************************************************************/
+
+  void TransferGroup::dump(std::ostream &stream) {
 
-    std::cout << "=== Accessors added to this group: " << std::endl;
+    stream << "=== Accessors added to this group: " << std::endl;
     for(auto &elem : highLevelElements) {
-      std::cout << " - " << elem->getName() << std::endl;
+      stream << " - " << elem->getName() << std::endl;
     }
-    std::cout << "=== Low-level transfer elements in this group: " << std::endl;
+    stream << "=== Low-level transfer elements in this group: " << std::endl;
     for(auto &elem : lowLevelElements) {
-      std::cout << " - " << elem->getName() << std::endl;
+      stream << " - " << elem->getName() << std::endl;
+    }
+    stream << "=== Transfer plan (maximum merge gap " << maxMergeGap << " bytes"
+           << (parallelTransfers ? ", backends in parallel" : "") << "): " << std::endl;
+    size_t backendIndex = 0;
+    for(auto &backendAndTransfers : transfersByBackend) {
+      auto &transfers = backendAndTransfers.second;
+      if(backendAndTransfers.first) {
+        stream << " - Backend #" << backendIndex++ << ":" << std::endl;
+      }
+      else {
+        stream << " - Unknown backend:" << std::endl;
+      }
+      for(auto &elem : transfers.otherElements) {
+        stream << "   - separate transfer: " << elem->getName() << std::endl;
+      }
+      if(transfers.numericAddressedElements.empty()) continue;
+      stream << "   - one readv()/writev() with " << transfers.numericAddressedElements.size() << " range(s)"
+             << std::endl;
+      for(auto &elem : transfers.numericAddressedElements) {
+        auto range = elem->getTransferRange();
+        stream << "     - bar " << static_cast<int>(range.bar) << ", address " << range.address << ", "
+               << range.sizeInBytes << " bytes";
+        size_t nUnusedBytes = elem->getNumberOfUnusedBytes();
+        if(nUnusedBytes > 0) stream << " (" << nUnusedBytes << " bytes unused, not written)";
+        stream << std::endl;
+      }
     }
-    std::cout << "===" << std::endl;
+    stream << "===" << std::endl;
 
   }
 
@@ -1,6 +1,7 @@
 #ifndef CHIMERA_TK_DEVICE_BACKEND_IMPL_H
 #define CHIMERA_TK_DEVICE_BACKEND_IMPL_H
 
+#include <atomic>
 #include <list>
 
 #include "DeviceBackend.h"
@@ -59,8 +60,8 @@ namespace ChimeraTK {
       /** the register catalogue containing describing the registers known by this backend */
       RegisterCatalogue _catalogue;
 
-      /** flag if device is opened */
-      bool        _opened;
+      /** flag if device is opened. Atomic, so backends can check it without holding a lock. */
+      std::atomic<bool> _opened;
       
       /** flag if device is connected. */
       bool        _connected;
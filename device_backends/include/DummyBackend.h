@@ -1,10 +1,11 @@
 #ifndef CHIMERA_TK_DUMMY_BACKEND_H
 #define CHIMERA_TK_DUMMY_BACKEND_H
 
+#include <array>
+#include <atomic>
 #include <vector>
 #include <map>
 #include <list>
-#include <set>
 #include <mutex>
 
 #include <boost/function.hpp>
@@ -47,6 +48,10 @@ namespace ChimeraTK {
    *  Registers can be set to read-only mode. In this
    *  case a write operation will just be ignored and no callback
    *  function is executed.
+   *
+   *  Reading does not take the mutex, so any number of threads can read concurrently without blocking each other.
+   *  Each bar is protected by a sequence counter instead (seqlock): a reader copies the data and retries if a write
+   *  to the same bar has happened in the meantime. Writes are serialised by the mutex.
    */
   class DummyBackend : public NumericAddressedBackend
   {
@@ -66,6 +71,15 @@ namespace ChimeraTK {
       virtual void read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes);
       virtual void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes);
 
+      /** Read all ranges. The DummyBackend itself reads them without calling read(). For derived classes, which
+       *  might override read(), read() is called for each range. */
+      void readv(const std::vector<TransferRange> &ranges) override;
+
+      /** Write all ranges while holding the mutex only once. The write callback functions are executed afterwards
+       *  for each range. Like readv(), this is only done by the DummyBackend itself, derived classes call write() for
+       *  each range. */
+      void writev(const std::vector<TransferRange> &ranges) override;
+
       virtual std::string readDeviceInfo();
 
       /// A virtual address is an address is a virtual 64 bit address space
@@ -93,8 +107,32 @@ namespace ChimeraTK {
       std::string _mapFile;
 
       std::map< uint8_t, std::vector<int32_t> > _barContents;
-      std::set< uint64_t > _readOnlyAddresses;
-      std::multimap< AddressRange, boost::function<void(void)> > _writeCallbackFunctions;
+
+      /** Lookup of a bar by its number for the read and write path, together with the sequence counter of the bar. */
+      struct BarAccess {
+        /// the contents of the bar in _barContents, or nullptr if the bar does not exist
+        std::vector<int32_t> *contents{nullptr};
+        /// incremented before and after each write to the bar, so it is odd while a write is in progress
+        std::atomic<uint32_t> sequence{0};
+      };
+      std::array<BarAccess, 256> _bars;
+
+
+      /** Read-only address ranges, as map of the first virtual address (see calculateVirtualAddress()) to the end of
+       *  the range (exclusive). Overlapping and adjacent ranges are merged, so the ranges never touch each other. */
+      std::map< uint64_t, uint64_t > _readOnlyRanges;
+
+      struct WriteCallback {
+        AddressRange range;
+        boost::function<void(void)> function;
+      };
+      /// The write callback functions in the order of registration
+      std::vector< WriteCallback > _writeCallbackFunctions;
+
+      /** Interval index of the write callback functions. The virtual address space is split into segments at the
+       *  begin and the end of each callback range. The key is the first virtual address of a segment, the value
+       *  contains the indices in _writeCallbackFunctions of all callbacks covering the segment up to the next key. */
+      std::map< uint64_t, std::vector<size_t> > _writeCallbackIndex;
       RegisterInfoMapPointer _registerMapping;
       std::mutex mutex;
 
@@ -109,8 +147,25 @@ namespace ChimeraTK {
           boost::function<void(void)>  const & writeCallbackFunction );
       /// returns true if the ranges overlap and at least one of the overlapping registers can be written
       bool isWriteRangeOverlap( AddressRange firstRange, AddressRange secondRange);
+      /// returns the read-only range containing the virtual address, or the end of _readOnlyRanges
+      std::map< uint64_t, uint64_t >::const_iterator findReadOnlyRange( uint64_t virtualAddress ) const;
+      /// make sure a segment of _writeCallbackIndex starts at the virtual address
+      void splitWriteCallbackSegment( uint64_t virtualAddress );
       static void checkSizeIsMultipleOfWordSize(size_t sizeInBytes);
 
+      /// Implementation of read() and readv(). Does not need the mutex.
+      void readInternal(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes);
+
+      /// Check that the address range lies inside the bar and return a pointer to the first word in the bar contents.
+      int32_t* getBarData(uint8_t bar, uint32_t address, size_t sizeInBytes);
+
+      /// Mark the begin and end of a write to the bar for concurrent readers. The mutex must be held by the caller.
+      void beginBarWrite(uint8_t bar);
+      void endBarWrite(uint8_t bar);
+
+      /// Implementation of write() and writev() without the callback functions. The mutex must be held by the caller.
+      void writeInternal(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes);
+
       /// Not write-protected function for internal use only. It does not trigger
       /// the callback function so it can be used inside a callback function for
       /// resynchronisation.
@@ -132,6 +132,10 @@ namespace ChimeraTK {
         _target->transferFutureWaitCallback();
       }
 
+      bool setReadyListener(std::function<void()> listener) override {
+        return _target->setReadyListener(std::move(listener));
+      }
+
       bool isReadOnly() const override {
         return _target->isReadOnly();
       }
@@ -144,6 +148,10 @@ namespace ChimeraTK {
         return _target->isWriteable();
       }
 
+      size_t getNumberOfOverflows() const override {
+        return _target->getNumberOfOverflows();
+      }
+
       std::vector< boost::shared_ptr<ChimeraTK::TransferElement> > getHardwareAccessingElements() override {
         return _target->getHardwareAccessingElements();
       }
@@ -29,6 +29,35 @@ namespace ChimeraTK {
 
       virtual void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes) = 0;
 
+      /** A contiguous address range with the buffer to transfer it from/to, used by readv() and writev(). */
+      struct TransferRange {
+        uint8_t bar;
+        uint32_t address;
+        int32_t *data;
+        size_t sizeInBytes;
+      };
+
+      /** Read multiple address ranges in one go, e.g. for all registers of a TransferGroup. The default implementation
+       *  just calls read() for each range. Backends which can do better (e.g. acquire a lock only once or send a single
+       *  request over the network) should override this function. */
+      virtual void readv(const std::vector<TransferRange> &ranges);
+
+      /** Write multiple address ranges in one go. The data is only read from the buffers. The default implementation
+       *  just calls write() for each range. */
+      virtual void writev(const std::vector<TransferRange> &ranges);
+
+      /** Obtain the current value of the write counter of the given bar, which is the starting point for
+       *  waitForWrite(). Only backends which support AccessMode::wait_for_new_data implement this function, the default
+       *  implementation throws a DeviceException with the id NOT_IMPLEMENTED. */
+      virtual uint32_t getWriteCount(uint8_t bar);
+
+      /** Check whether the given address range has been written since the write counter of the bar had the value
+       *  writeCount. If blocking is true, wait until this is the case. writeCount is updated to the current value of
+       *  the counter, so the next call only reports later writes. Returns whether the range has been written. The
+       *  default implementation throws a DeviceException with the id NOT_IMPLEMENTED. */
+      virtual bool waitForWrite(uint8_t bar, uint32_t address, size_t sizeInBytes, uint32_t &writeCount,
+          bool blocking);
+
       virtual std::string readDeviceInfo() = 0;
 
       boost::shared_ptr<const RegisterInfoMap> getRegisterMap() const;
@@ -27,7 +27,8 @@ namespace ChimeraTK {
     public:
 
       NumericAddressedBackendMuxedRegisterAccessor(const RegisterPath &registerPathName,
-          size_t numberOfElements, size_t elementsOffset, boost::shared_ptr<DeviceBackend> _backend );
+          size_t numberOfElements, size_t elementsOffset, boost::shared_ptr<DeviceBackend> _backend,
+          AccessModeFlags flags );
 
       virtual ~NumericAddressedBackendMuxedRegisterAccessor() {
         this->shutdown();
@@ -61,6 +62,7 @@ namespace ChimeraTK {
         if(_numberOfElements != rhsCasted->_numberOfElements) return false;
         if(_elementsOffset != rhsCasted->_elementsOffset) return false;
         if(_converters != rhsCasted->_converters) return false;
+        if(_saturate != rhsCasted->_saturate) return false;
         return true;
       }
 
@@ -76,11 +78,19 @@ namespace ChimeraTK {
         return true;
       }
 
+      size_t getNumberOfOverflows() const override {
+        return _nOverflows;
+      }
+
       FixedPointConverter getFixedPointConverter() const override {
         throw DeviceException("getFixedPointConverter is not implemented for 2D registers (and deprecated for all "
             "registers).", DeviceException::NOT_IMPLEMENTED);
       }
 
+      const DeviceBackend* getTransferBackend() const override {
+        return _ioDevice.get();
+      }
+
     protected:
 
       /** One fixed point converter for each sequence. */
@@ -94,8 +104,16 @@ namespace ChimeraTK {
 
       std::vector<int32_t> _ioBuffer;
 
+      /** Buffer holding the raw values of a single sequence, so the conversion can be done for the entire sequence at
+       *  once */
+      std::vector<uint32_t> _sequenceBuffer;
+
       std::vector<RegisterInfoMap::RegisterInfo> _sequenceInfos;
 
+      /** flag whether AccessMode::saturate is set, and the number of saturated values in the last read transfer */
+      bool _saturate;
+      size_t _nOverflows;
+
       uint32_t bytesPerBlock;
 
       /// register and module name
@@ -126,14 +144,18 @@ namespace ChimeraTK {
   template <class UserType>
   NumericAddressedBackendMuxedRegisterAccessor<UserType>::NumericAddressedBackendMuxedRegisterAccessor(
         const RegisterPath &registerPathName, size_t numberOfElements, size_t elementsOffset,
-        boost::shared_ptr<DeviceBackend> _backend )
+        boost::shared_ptr<DeviceBackend> _backend, AccessModeFlags flags )
   : SyncNDRegisterAccessor<UserType>(registerPathName),
     _ioDevice(boost::dynamic_pointer_cast<NumericAddressedBackend>(_backend)),
+    _saturate(flags.has(AccessMode::saturate)),
+    _nOverflows(0),
     _registerPathName(registerPathName),
     _numberOfElements(numberOfElements),
     _elementsOffset(elementsOffset)
   {
     try {
+      this->setReadAsyncAffinity(_ioDevice.get());
+
       // re-split register and module after merging names by the last dot (to allow module.register in the register name)
       _registerPathName.setAltSeparator(".");
       auto moduleAndRegister = MapFileParser::splitStringAtLastDot(_registerPathName.getWithAltSeparator());
@@ -176,6 +198,10 @@ namespace ChimeraTK {
         // store sequence info and fixed point converter
         _sequenceInfos.push_back(sequenceInfo);
         _converters.push_back( FixedPointConverter(registerPathName, sequenceInfo.width, sequenceInfo.nFractionalBits, sequenceInfo.signedFlag) );
+
+        // Multiplexed areas typically contain many narrow sequences: use lookup tables for the conversion. This has no
+        // effect for wide sequences.
+        _converters.back().enableLookupTable();
       }
 
       // check if no sequences were found
@@ -228,8 +254,9 @@ namespace ChimeraTK {
         NDRegisterAccessor<UserType>::buffer_2D[i].resize(_nBlocks);
       }
 
-      // allocate the raw io buffer
+      // allocate the raw io buffer and the buffer for the (de)multiplexed raw values of one sequence
       _ioBuffer.resize(_nBytes/sizeof(int32_t));
+      _sequenceBuffer.resize(_nBlocks);
     }
     catch(...) {
       this->shutdown();
@@ -249,25 +276,36 @@ namespace ChimeraTK {
   template <class UserType>
   void NumericAddressedBackendMuxedRegisterAccessor<UserType>::doPostRead() {
       uint8_t *standOfMyioBuffer = reinterpret_cast<uint8_t*>(&_ioBuffer[0]);
-      for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
-        for(size_t sequenceIndex = 0; sequenceIndex < _converters.size(); ++sequenceIndex) {
-          switch(_sequenceInfos[sequenceIndex].nBytes) {
-            case 1: //8 bit variables
-              NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] =
-                  _converters[sequenceIndex].template toCooked<UserType>(*(standOfMyioBuffer));
-              standOfMyioBuffer++;
-              break;
-            case 2: //16 bit words
-              NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] =
-                  _converters[sequenceIndex].template toCooked<UserType>(*(reinterpret_cast<uint16_t*>(standOfMyioBuffer)));
-              standOfMyioBuffer = standOfMyioBuffer + 2;
-              break;
-            case 4: //32 bit words
-              NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] =
-                  _converters[sequenceIndex].template toCooked<UserType>(*(reinterpret_cast<uint32_t*>(standOfMyioBuffer)));
-              standOfMyioBuffer = standOfMyioBuffer + 4;
-              break;
-          }
+      _nOverflows = 0;
+      for(size_t sequenceIndex = 0; sequenceIndex < _converters.size(); ++sequenceIndex) {
+        // demultiplex the raw values of this sequence
+        switch(_sequenceInfos[sequenceIndex].nBytes) {
+          case 1: //8 bit variables
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              _sequenceBuffer[blockIndex] = *(standOfMyioBuffer + blockIndex*bytesPerBlock);
+            }
+            break;
+          case 2: //16 bit words
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              _sequenceBuffer[blockIndex] = *(reinterpret_cast<uint16_t*>(standOfMyioBuffer + blockIndex*bytesPerBlock));
+            }
+            break;
+          case 4: //32 bit words
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              _sequenceBuffer[blockIndex] = *(reinterpret_cast<uint32_t*>(standOfMyioBuffer + blockIndex*bytesPerBlock));
+            }
+            break;
+        }
+        standOfMyioBuffer += _sequenceInfos[sequenceIndex].nBytes;
+
+        // convert the entire sequence at once
+        if(_saturate) {
+          _nOverflows += _converters[sequenceIndex].template toCookedSaturating<UserType>(_sequenceBuffer.data(),
+              NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex].data(), _nBlocks);
+        }
+        else {
+          _converters[sequenceIndex].template toCooked<UserType>(_sequenceBuffer.data(),
+              NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex].data(), _nBlocks);
         }
       }
 
@@ -287,26 +325,30 @@ namespace ChimeraTK {
   template<class UserType>
   void NumericAddressedBackendMuxedRegisterAccessor<UserType>::doPreWrite() {
       uint8_t *standOfMyioBuffer = reinterpret_cast<uint8_t*>(&_ioBuffer[0]);
-      for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
-        for(size_t sequenceIndex = 0; sequenceIndex < _converters.size(); ++sequenceIndex) {
-          switch(_sequenceInfos[sequenceIndex].nBytes){
-            case 1: //8 bit variables
-              *(standOfMyioBuffer) = _converters[sequenceIndex].toRaw(
-                  NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] );
-              standOfMyioBuffer++;
-              break;
-            case 2: //16 bit variables
-              *(reinterpret_cast<uint16_t*>(standOfMyioBuffer)) = _converters[sequenceIndex].toRaw(
-                  NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] );
-              standOfMyioBuffer = standOfMyioBuffer + 2;
-              break;
-            case 4: //32 bit variables
-              *(reinterpret_cast<uint32_t*>(standOfMyioBuffer)) = _converters[sequenceIndex].toRaw(
-                  NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex][blockIndex] );
-              standOfMyioBuffer = standOfMyioBuffer + 4;
-              break;
-          }
+      for(size_t sequenceIndex = 0; sequenceIndex < _converters.size(); ++sequenceIndex) {
+        // convert the entire sequence at once
+        _converters[sequenceIndex].toRaw(NDRegisterAccessor<UserType>::buffer_2D[sequenceIndex].data(),
+            _sequenceBuffer.data(), _nBlocks);
+
+        // multiplex the raw values of this sequence
+        switch(_sequenceInfos[sequenceIndex].nBytes){
+          case 1: //8 bit variables
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              *(standOfMyioBuffer + blockIndex*bytesPerBlock) = _sequenceBuffer[blockIndex];
+            }
+            break;
+          case 2: //16 bit variables
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              *(reinterpret_cast<uint16_t*>(standOfMyioBuffer + blockIndex*bytesPerBlock)) = _sequenceBuffer[blockIndex];
+            }
+            break;
+          case 4: //32 bit variables
+            for(size_t blockIndex = 0; blockIndex < _nBlocks; ++blockIndex) {
+              *(reinterpret_cast<uint32_t*>(standOfMyioBuffer + blockIndex*bytesPerBlock)) = _sequenceBuffer[blockIndex];
+            }
+            break;
         }
+        standOfMyioBuffer += _sequenceInfos[sequenceIndex].nBytes;
       }
   }
   DECLARE_TEMPLATE_FOR_CHIMERATK_USER_TYPES(NumericAddressedBackendMuxedRegisterAccessor);
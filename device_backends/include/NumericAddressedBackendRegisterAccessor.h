@@ -12,6 +12,7 @@
 #include "NumericAddressedLowLevelTransferElement.h"
 #include "FixedPointConverter.h"
 #include "ForwardDeclarations.h"
+#include "ReadAsyncThreadPool.h"
 
 namespace ChimeraTK {
 
@@ -27,12 +28,16 @@ namespace ChimeraTK {
       : SyncNDRegisterAccessor<UserType>(registerPathName),
         _fixedPointConverter(registerPathName),
         isRaw(false),
+        _rawEqualsCooked(false),
+        _saturate(flags.has(AccessMode::saturate)),
+        _nOverflows(0),
+        _waitForNewData(flags.has(AccessMode::wait_for_new_data)),
         _registerPathName(registerPathName),
         _numberOfWords(numberOfWords)
       {
         try {
           // check for unknown flags
-          flags.checkForUnknownFlags({AccessMode::raw});
+          flags.checkForUnknownFlags({AccessMode::raw, AccessMode::saturate, AccessMode::wait_for_new_data});
 
           // check device backend
           _dev = boost::dynamic_pointer_cast<NumericAddressedBackend>(dev);
@@ -40,6 +45,7 @@ namespace ChimeraTK {
             throw DeviceException("NumericAddressedBackendRegisterAccessor is used with a backend which is not "
                 "a NumericAddressedBackend.", DeviceException::WRONG_PARAMETER);
           }
+          this->setReadAsyncAffinity(_dev.get());
 
           // obtain register information
           boost::shared_ptr<RegisterInfo> info = _dev->getRegisterInfo(registerPathName);
@@ -60,6 +66,11 @@ namespace ChimeraTK {
                 DeviceException::WRONG_PARAMETER);
           }
 
+          // only writes after the creation of the accessor count as new data
+          if(_waitForNewData) {
+            _writeCount = _dev->getWriteCount(_bar);
+          }
+
           // create low-level transfer element handling the actual data transfer to the hardware with raw data
           _rawAccessor.reset(new NumericAddressedLowLevelTransferElement(_dev,_bar,_startAddress,_numberOfWords));
 
@@ -82,6 +93,11 @@ namespace ChimeraTK {
             }
             isRaw = true;
           }
+
+          // For int32_t the conversion is the identity if the register is a 32 bit signed integer. The buffers can
+          // then be exchanged with the low-level transfer element like in raw mode instead of being converted.
+          _rawEqualsCooked = isRaw || ( typeid(UserType) == typeid(int32_t) &&
+                                        _fixedPointConverter == FixedPointConverter(_registerPathName, 32, 0, true) );
         }
         catch(...) {
           this->shutdown();
@@ -97,17 +113,26 @@ namespace ChimeraTK {
       };
 
       void doReadTransfer() override {
+        if(_waitForNewData) {
+          // the wait must not occupy one of the limited threads of the ReadAsyncThreadPool
+          ReadAsyncThreadPool::BlockingSection blocking;
+          _dev->waitForWrite(_bar, _startAddress, _numberOfWords*sizeof(int32_t), _writeCount, true);
+        }
         _rawAccessor->read();
       }
 
       bool doReadTransferNonBlocking() override {
+        if(_waitForNewData &&
+           !_dev->waitForWrite(_bar, _startAddress, _numberOfWords*sizeof(int32_t), _writeCount, false)) {
+          return false;
+        }
         _rawAccessor->read();
         return true;
       }
 
       bool doReadTransferLatest() override {
-        _rawAccessor->read();
-        return true;
+        // the backend only keeps the latest value, so this is the same as a non-blocking read
+        return doReadTransferNonBlocking();
       }
 
       bool doWriteTransfer(ChimeraTK::VersionNumber /*versionNumber*/={}) override {
@@ -121,23 +146,22 @@ namespace ChimeraTK {
 
       void doPostRead() override {
         auto itsrc = _rawAccessor->begin(_startAddress);
-        for(auto itdst = NDRegisterAccessor<UserType>::buffer_2D[0].begin();
-                 itdst != NDRegisterAccessor<UserType>::buffer_2D[0].end();
-               ++itdst) {
-          *itdst = _fixedPointConverter.toCooked<UserType>(*itsrc);
-          ++itsrc;
+        if(_saturate) {
+          _nOverflows = _fixedPointConverter.toCookedSaturating<UserType>(reinterpret_cast<const uint32_t*>(&(*itsrc)),
+                                                                          NDRegisterAccessor<UserType>::buffer_2D[0].data(),
+                                                                          _numberOfWords);
+        }
+        else {
+          _fixedPointConverter.toCooked<UserType>(reinterpret_cast<const uint32_t*>(&(*itsrc)),
+                                                  NDRegisterAccessor<UserType>::buffer_2D[0].data(), _numberOfWords);
         }
         SyncNDRegisterAccessor<UserType>::doPostRead();
       };
 
       void doPreWrite() override {
-        auto itsrc = _rawAccessor->begin(_startAddress);
-        for(auto itdst = NDRegisterAccessor<UserType>::buffer_2D[0].begin();
-                 itdst != NDRegisterAccessor<UserType>::buffer_2D[0].end();
-               ++itdst) {
-          *itsrc = _fixedPointConverter.toRaw<UserType>(*itdst);
-          ++itsrc;
-        }
+        auto itdst = _rawAccessor->begin(_startAddress);
+        _fixedPointConverter.toRaw<UserType>(NDRegisterAccessor<UserType>::buffer_2D[0].data(),
+                                             reinterpret_cast<uint32_t*>(&(*itdst)), _numberOfWords);
       };
 
       void doPostWrite() override {
@@ -151,6 +175,8 @@ namespace ChimeraTK {
         if(_startAddress != rhsCasted->_startAddress) return false;
         if(_numberOfWords != rhsCasted->_numberOfWords) return false;
         if(isRaw != rhsCasted->isRaw) return false;
+        if(_saturate != rhsCasted->_saturate) return false;
+        if(_waitForNewData != rhsCasted->_waitForNewData) return false;
         if(_fixedPointConverter != rhsCasted->_fixedPointConverter) return false;
         return true;
       }
@@ -167,6 +193,14 @@ namespace ChimeraTK {
         return true;
       }
 
+      size_t getNumberOfOverflows() const override {
+        return _nOverflows;
+      }
+
+      bool isWaitingForNewData() const override {
+        return _waitForNewData;
+      }
+
       /** Get the FixedPointConverter. In case of a raw accessor this is the
        *  conversion that would be used if the data should be coocked.
        */
@@ -192,6 +226,20 @@ namespace ChimeraTK {
       FixedPointConverter _fixedPointConverter;
       bool isRaw;
 
+      /** flag whether the raw data can be used as cooked data without conversion (raw mode or an int32_t accessor for a
+       *  32 bit signed integer register). Only used for int32_t, in which case the buffers are swapped resp. copied
+       *  instead of converted. */
+      bool _rawEqualsCooked;
+
+      /** flag whether AccessMode::saturate is set, and the number of saturated values in the last read transfer */
+      bool _saturate;
+      size_t _nOverflows;
+
+      /** flag whether AccessMode::wait_for_new_data is set, and the write counter of the bar after the last read
+       *  transfer (see NumericAddressedBackend::waitForWrite()) */
+      bool _waitForNewData;
+      uint32_t _writeCount{0};
+
       /** register and module name */
       RegisterPath _registerPathName;
 
@@ -226,6 +274,7 @@ namespace ChimeraTK {
                                            _rawAccessor->_startAddress+_rawAccessor->_numberOfBytes);
           size_t newNumberOfWords = (newStopAddress-newStartAddress)/sizeof(int32_t);
           casted->changeAddress(newStartAddress,newNumberOfWords);
+          casted->addUsedRanges(*_rawAccessor);
           _rawAccessor = casted;
         }
       }
@@ -8,6 +8,8 @@
 #ifndef CHIMERA_TK_NUMERIC_ADDRESSED_LOW_LEVEL_TRANSFER_ELEMENT_H
 #define CHIMERA_TK_NUMERIC_ADDRESSED_LOW_LEVEL_TRANSFER_ELEMENT_H
 
+#include <algorithm>
+
 #include "TransferElement.h"
 #include "NumericAddressedBackend.h"
 #include "FixedPointConverter.h"
@@ -32,6 +34,7 @@ namespace ChimeraTK {
       : _dev(dev), _bar(bar), isShared(false)
       {
         setAddress(startAddress, numberOfWords);
+        _usedRanges.emplace_back(_startAddress, _startAddress + _numberOfBytes);
       }
 
       virtual ~NumericAddressedLowLevelTransferElement() {};
@@ -41,7 +44,14 @@ namespace ChimeraTK {
       }
 
       bool doWriteTransfer(ChimeraTK::VersionNumber /*versionNumber*/={}) override {
-        _dev->write(_bar, _startAddress, rawDataBuffer.data(), _numberOfBytes);
+        if(_usedRanges.size() == 1) {
+          _dev->write(_bar, _startAddress, rawDataBuffer.data(), _numberOfBytes);
+        }
+        else {
+          std::vector<NumericAddressedBackend::TransferRange> ranges;
+          appendWriteTransferRanges(ranges);
+          _dev->writev(ranges);
+        }
         return false;
       }
 
@@ -62,7 +72,8 @@ namespace ChimeraTK {
                               DeviceException::NOT_IMPLEMENTED);                                            // LCOV_EXCL_LINE
       }                                                                                                     // LCOV_EXCL_LINE
 
-      /** Check if the address areas are adjacent and/or overlapping.
+      /** Check if the address areas are adjacent and/or overlapping, or separated by a gap of at most the maximum
+       *  merge gap (see setMaxMergeGap()).
        *  NumericAddressedBackendRegisterAccessor::replaceTransferElement() takes care of replacing the
        *  NumericAddressedBackendRawAccessors with a single NumericAddressedBackendRawAccessor covering the address
        *  space of both accessors. */
@@ -73,12 +84,58 @@ namespace ChimeraTK {
         if(_dev != rhsCasted->_dev) return false;
         if(_bar != rhsCasted->_bar) return false;
 
-        // only allow adjacent and overlapping address areas to be merged
-        if(_startAddress + _numberOfBytes < rhsCasted->_startAddress) return false;
-        if(_startAddress > rhsCasted->_startAddress + rhsCasted->_numberOfBytes) return false;
+        // only allow adjacent and overlapping address areas to be merged, or areas with a small enough gap
+        size_t maxGap = std::max(_maxMergeGap, rhsCasted->_maxMergeGap);
+        if(_startAddress + _numberOfBytes + maxGap < rhsCasted->_startAddress) return false;
+        if(_startAddress > rhsCasted->_startAddress + rhsCasted->_numberOfBytes + maxGap) return false;
+
+        // a gap must be a multiple of the word size, since the raw buffer is accessed word-wise
+        if(_startAddress + _numberOfBytes < rhsCasted->_startAddress ||
+           _startAddress > rhsCasted->_startAddress + rhsCasted->_numberOfBytes) {
+          if((std::max(_startAddress, rhsCasted->_startAddress) -
+              std::min(_startAddress, rhsCasted->_startAddress)) % sizeof(int32_t) != 0) return false;
+        }
         return true;
       }
 
+      /** Set the maximum gap in bytes between two address areas which still allows merging them in isMergeable().
+       *  The merged transfer reads the words in the gap, but never writes them. */
+      void setMaxMergeGap(size_t maxMergeGap) {
+        _maxMergeGap = maxMergeGap;
+      }
+
+      /** Return the number of bytes which are transferred when reading but are not used by any accessor. */
+      size_t getNumberOfUnusedBytes() const {
+        size_t nUsedBytes = 0;
+        for(auto &range : _usedRanges) nUsedBytes += range.second - range.first;
+        return _numberOfBytes - nUsedBytes;
+      }
+
+      /** Return the backend used for the hardware access. */
+      const boost::shared_ptr<NumericAddressedBackend>& getBackend() const {
+        return _dev;
+      }
+
+      const DeviceBackend* getTransferBackend() const override {
+        return _dev.get();
+      }
+
+      /** Return the address range and buffer of this element, so the transfer can be done as part of
+       *  NumericAddressedBackend::readv() or writev() instead of doReadTransfer() or doWriteTransfer(). */
+      NumericAddressedBackend::TransferRange getTransferRange() {
+        return { static_cast<uint8_t>(_bar), static_cast<uint32_t>(_startAddress), rawDataBuffer.data(), _numberOfBytes };
+      }
+
+      /** Append the address ranges to be written to the given list. In contrast to getTransferRange(), gaps between
+       *  the merged address areas are left out, so this might be more than one range. */
+      void appendWriteTransferRanges(std::vector<NumericAddressedBackend::TransferRange> &ranges) {
+        for(auto &range : _usedRanges) {
+          ranges.push_back({ static_cast<uint8_t>(_bar), static_cast<uint32_t>(range.first),
+                             rawDataBuffer.data() + (range.first - _startAddress)/sizeof(int32_t),
+                             range.second - range.first });
+        }
+      }
+
       bool mayReplaceOther(const boost::shared_ptr<TransferElement const> &) const override {
         return false;   // never used, since isMergeable() is used instead
       }
@@ -116,6 +173,23 @@ namespace ChimeraTK {
         isShared = true;
       }
 
+      /** Add the used address ranges of another element, which is merged into this element. Overlapping and adjacent
+       *  ranges are combined. */
+      void addUsedRanges(const NumericAddressedLowLevelTransferElement &other) {
+        auto ranges = _usedRanges;
+        ranges.insert(ranges.end(), other._usedRanges.begin(), other._usedRanges.end());
+        std::sort(ranges.begin(), ranges.end());
+        _usedRanges.clear();
+        for(auto &range : ranges) {
+          if(!_usedRanges.empty() && range.first <= _usedRanges.back().second) {
+            _usedRanges.back().second = std::max(_usedRanges.back().second, range.second);
+          }
+          else {
+            _usedRanges.push_back(range);
+          }
+        }
+      }
+
     protected:
 
       /** Set the start address (inside the bar given in the constructor) and number of words of this accessor. */
@@ -153,6 +227,13 @@ namespace ChimeraTK {
        *  accessors */
       bool isShared;
 
+      /** maximum gap in bytes between address areas which are still merged, see setMaxMergeGap() */
+      size_t _maxMergeGap{0};
+
+      /** address ranges [begin, end) used by the accessors sharing this element, sorted and without overlaps. Only if
+       *  address areas have been merged across a gap, there is more than one range. */
+      std::vector< std::pair<size_t, size_t> > _usedRanges;
+
       /** raw buffer */
       std::vector<int32_t> rawDataBuffer;
 
@@ -0,0 +1,147 @@
+/*
+ * ReadAsyncThreadPool.h
+ */
+
+#ifndef CHIMERA_TK_READ_ASYNC_THREAD_POOL_H
+#define CHIMERA_TK_READ_ASYNC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+
+#include <boost/thread.hpp>
+
+namespace ChimeraTK {
+
+  /** Pool of persistent worker threads executing the synchronous transfers of SyncNDRegisterAccessor::readAsync() and
+   *  of TransferElement::writeAsync().
+   *
+   *  Tasks are submitted to a shared FIFO queue and picked up by idle workers. If no worker is idle, a new worker is
+   *  started as long as the maximum number of threads has not been reached, otherwise the task waits in the queue.
+   *  Idle workers stay alive, so after a short warm-up phase no threads are created any more. Only workers exceeding
+   *  the maximum (see below and setMaxNumberOfThreads()) exit once they become idle.
+   *
+   *  The synchronous transfers of some backends block until data arrives. Such transfers mark their wait with a
+   *  BlockingSection, and workers inside it do not count towards the maximum number of threads. Any number of
+   *  transfers can hence wait at the same time without starving the other tasks, at the cost of one thread each.
+   *
+   *  Each task can carry an affinity key (typically the backend). A worker which has just finished a task prefers
+   *  the next queued task with the same key, so transfers to the same backend tend to stay on the same thread. This
+   *  is only a preference: transfers to the same backend are never serialised by the pool. */
+  class ReadAsyncThreadPool {
+
+    public:
+
+      /** A task which can be submitted to the pool. The task is owned by the submitter and can be submitted again
+       *  once it has completed, without any allocation. The task object must not be destroyed while being queued
+       *  or executed, call ReadAsyncThreadPool::cancel() before. */
+      class Task {
+        public:
+          Task(std::function<void()> function, const void *affinity = nullptr)
+          : _function(std::move(function)), _affinity(affinity) {}
+
+          Task(const Task &other) = delete;
+          Task& operator=(const Task &other) = delete;
+
+          /** Change the affinity key. Must not be called while the task is queued or executed. */
+          void setAffinity(const void *affinity) { _affinity = affinity; }
+
+        private:
+          friend class ReadAsyncThreadPool;
+
+          enum class State { idle, queued, running, runningAndQueued };
+
+          std::function<void()> _function;
+          const void *_affinity;
+          State _state{State::idle};
+
+          /// Flag whether the task has been created by post() and is deleted by the pool after execution
+          bool _ownedByPool{false};
+
+          /// Worker thread currently executing the task, only valid in the running states
+          boost::thread *_worker{nullptr};
+      };
+
+      /** Marks the calling worker as blocked until data arrives for the lifetime of the object, e.g. while waiting in
+       *  NumericAddressedBackend::waitForWrite(). If tasks are queued, another worker is started for them, even beyond
+       *  the maximum number of threads. Has no effect if the calling thread is not a worker of the pool. */
+      class BlockingSection {
+        public:
+          BlockingSection();
+          ~BlockingSection();
+
+          BlockingSection(const BlockingSection &other) = delete;
+          BlockingSection& operator=(const BlockingSection &other) = delete;
+
+        private:
+          bool _isWorker;
+      };
+
+      /** Obtain the global instance of the pool. */
+      static ReadAsyncThreadPool& getInstance();
+
+      /** Queue the task for execution. If the task is currently executed, it will be executed once more after
+       *  completion. If it is already queued, nothing happens. */
+      void submit(Task &task);
+
+      /** Execute the given function once in the pool. In contrast to submit(), the pool creates and owns the task, so
+       *  it cannot be cancelled. The function must handle all exceptions itself. */
+      void post(std::function<void()> function, const void *affinity = nullptr);
+
+      /** Make sure the task is neither queued nor executed any more. A queued task is removed from the queue. If the
+       *  task is currently executed, the executing thread is interrupted (see boost::thread::interrupt()) and the
+       *  function blocks until the execution has ended. Must not be called from within the task itself. */
+      void cancel(Task &task);
+
+      /** Set the maximum number of worker threads. If the new maximum is smaller than the current number of workers,
+       *  the surplus workers exit once they have finished their current task. Workers blocked in a BlockingSection
+       *  are not counted. The default is 16. */
+      void setMaxNumberOfThreads(size_t maxNumberOfThreads);
+
+      /** Get the maximum number of worker threads. */
+      size_t getMaxNumberOfThreads();
+
+      /** Get the number of worker threads currently started. */
+      size_t getNumberOfThreads();
+
+    private:
+
+      ReadAsyncThreadPool() = default;
+      ReadAsyncThreadPool(const ReadAsyncThreadPool&) = delete;
+      ReadAsyncThreadPool& operator=(const ReadAsyncThreadPool&) = delete;
+
+      /** Main loop of the worker threads */
+      void workerLoop(boost::thread *self);
+
+      /** Queue the task and start a new worker if needed. The mutex must be held. */
+      void enqueue(Task &task);
+
+      /** Check whether there are more workers which are not blocked (see BlockingSection) than the maximum number of
+       *  threads. The mutex must be held. */
+      bool hasSurplusWorkers();
+
+      /** Start a new worker if there are more queued tasks than idle workers and the workers which are not blocked
+       *  (see BlockingSection) have not reached the maximum number of threads. The mutex must be held. */
+      void startWorkerIfNeeded();
+
+      /** Take the next task from the queue, preferring a task with the given affinity. The mutex must be held. */
+      Task* takeTask(const void *affinity);
+
+      /// Number of queue entries searched for a task with matching affinity before falling back to the first entry
+      static constexpr size_t affinitySearchDepth = 8;
+
+      std::mutex _mutex;
+      std::condition_variable _taskAvailable;
+      std::condition_variable _taskFinished;
+      std::deque<Task*> _queue;
+      std::list<boost::thread> _workers;
+      size_t _nIdleWorkers{0};
+      size_t _nBlockedWorkers{0};
+      size_t _maxNumberOfThreads{16};
+  };
+
+} // namespace ChimeraTK
+
+#endif /* CHIMERA_TK_READ_ASYNC_THREAD_POOL_H */
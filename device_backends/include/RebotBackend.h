@@ -15,6 +15,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/algorithm/string.hpp>
 #include <mutex>
+#include <atomic>
+#include <functional>
 #include <boost/thread.hpp>
 #include <boost/chrono.hpp>
 #include "NumericAddressedBackend.h"
@@ -37,6 +39,15 @@ namespace ChimeraTK {
     ThreadInformerMutex() : quitThread(false){}
   };
 
+  /// An additional connection of the connection pool, see RebotBackend::setNumberOfConnections()
+  struct RebotConnection{
+    std::mutex mutex;
+    // Only access the following members when holding the mutex.
+    boost::shared_ptr<TcpCtrl> tcpCommunicator;
+    std::unique_ptr<RebotProtocolImplementor> protocolImplementor;
+    boost::chrono::steady_clock::time_point lastSendTime;
+  };
+
   class RebotBackend : public NumericAddressedBackend {
 
     protected:
@@ -51,6 +62,15 @@ namespace ChimeraTK {
       /// The time when the last command (read/write/heartbeat) was send
       boost::chrono::steady_clock::time_point _lastSendTime;
       unsigned int _connectionTimeout;
+      /// Maximum number of requests in flight in readv() and writev()
+      std::atomic<size_t> _pipelineDepth;
+      /// Connections of the pool in addition to _tcpCommunicator. Only modified while holding
+      /// the mutex in _threadInformerMutex and the device is closed.
+      std::vector<std::unique_ptr<RebotConnection>> _additionalConnections;
+      /// Used to distribute the transfers over the connections if all of them are in use
+      std::atomic<size_t> _nextConnection;
+      /// Reads of at least this size are striped over all connections of the pool
+      std::atomic<size_t> _minStripedReadSize;
                            
     public:
       RebotBackend(std::string boardAddr, int port, std::string mapFileName="");
@@ -60,6 +80,22 @@ namespace ChimeraTK {
       void close() override;
       void read(uint8_t bar, uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) override;
       void write(uint8_t bar, uint32_t addressInBytes, int32_t const* data, size_t sizeInBytes) override;
+      /// Transfer all ranges while holding the connection mutex only once. Up to the pipeline depth
+      /// requests are sent before the first response is read.
+      void readv(const std::vector<TransferRange> &ranges) override;
+      void writev(const std::vector<TransferRange> &ranges) override;
+      /// Set the maximum number of requests in flight in readv() and writev(), e.g. for a TransferGroup.
+      /// The default is rebot::DEFAULT_PIPELINE_DEPTH. A depth of 1 waits for each response before
+      /// sending the next request.
+      void setPipelineDepth(size_t pipelineDepth);
+      /// Set the number of TCP connections to the board. Must be called while the backend is closed.
+      /// Each transfer uses one connection which is not in use by another thread, so several threads
+      /// can access the board concurrently. Large reads are striped over all connections (see
+      /// setMinStripedReadSize()). The default is 1, i.e. all transfers are serialised.
+      void setNumberOfConnections(size_t numberOfConnections);
+      /// Set the minimum size in bytes of a read which is striped over all connections of the pool.
+      /// The default is rebot::MIN_STRIPED_READ_SIZE.
+      void setMinStripedReadSize(size_t minStripedReadSize);
       std::string readDeviceInfo() override { return std::string("RebotDevice"); }
       static boost::shared_ptr<DeviceBackend> createInstance(
           std::string host, std::string instance,
@@ -68,7 +104,19 @@ namespace ChimeraTK {
    protected:
       // This is not in the protocol implementor. Only the result of the hello tells us
       // which implementor to instantiate.
-      uint32_t getServerProtocolVersion();
+      uint32_t getServerProtocolVersion(boost::shared_ptr<TcpCtrl> &tcpCommunicator);
+      /// Open the connection, negotiate the protocol version and create the matching implementor
+      std::unique_ptr<RebotProtocolImplementor> connect(boost::shared_ptr<TcpCtrl> &tcpCommunicator);
+
+      /// Execute the transfer on a connection of the pool, preferring one which is not in use
+      void transferOnAnyConnection(const std::function<void(RebotProtocolImplementor&)> &transfer);
+      /// Execute the transfer on the given connection. The mutex of the connection must be held.
+      void transferOnConnection(size_t connectionIndex,
+                                const std::function<void(RebotProtocolImplementor&)> &transfer);
+      /// Get the mutex protecting the given connection. Connection 0 is _tcpCommunicator.
+      std::mutex& getConnectionMutex(size_t connectionIndex);
+      /// Split a large read into one part per connection and transfer the parts in parallel
+      void readStriped(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes);
       std::vector<uint32_t> frameClientHello();
       uint32_t parseRxServerHello(const std::vector<int32_t>& serverHello);
 
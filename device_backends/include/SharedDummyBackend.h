@@ -1,16 +1,17 @@
 #ifndef MTCA4U_SHARED_DUMMY_BACKEND_H
 #define MTCA4U_SHARED_DUMMY_BACKEND_H
 
-#include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <list>
-#include <set>
 #include <mutex>
 #include <utility>
+#include <sys/types.h>
 
+#include <boost/interprocess/managed_mapped_file.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/interprocess/containers/vector.hpp>
-#include <boost/interprocess/allocators/allocator.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
 #include <boost/function.hpp>
 
@@ -19,11 +20,6 @@
 #include "NumericAddressedBackend.h"
 
 
-// Define shared-memory compatible vector type and corresponding allocator
-typedef boost::interprocess::allocator<int32_t, boost::interprocess::managed_shared_memory::segment_manager>  ShmemAllocator;
-typedef boost::interprocess::vector<int32_t, ShmemAllocator> SharedMemoryVector;
-
-
 namespace ChimeraTK {
 
   /** TODO DOCUMENTATION
@@ -31,7 +27,12 @@ namespace ChimeraTK {
   class SharedDummyBackend : public NumericAddressedBackend
   {
     public:
-      SharedDummyBackend(std::string instanceId, std::string mapFileName);
+      /** The register contents are shared by all SharedDummyBackends with the same instance id and map file name,
+       *  also across processes. By default the contents are placed in a POSIX shared memory segment. If
+       *  segmentDirectory is given, the segment is a file in this directory instead. On a hugetlbfs mount (e.g.
+       *  /dev/hugepages) this backs the segment with huge pages, which reduces the TLB pressure for large bars. All
+       *  processes sharing the instance must use the same directory. */
+      SharedDummyBackend(std::string instanceId, std::string mapFileName, std::string segmentDirectory = "");
       virtual ~SharedDummyBackend();
 
       virtual void open();
@@ -39,6 +40,9 @@ namespace ChimeraTK {
       virtual void read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes);
       virtual void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes);
       virtual std::string readDeviceInfo();
+      uint32_t getWriteCount(uint8_t bar) override;
+      bool waitForWrite(uint8_t bar, uint32_t address, size_t sizeInBytes, uint32_t &writeCount,
+          bool blocking) override;
       
       int32_t& getRegisterContent(uint8_t bar, uint32_t address);
 
@@ -52,9 +56,38 @@ namespace ChimeraTK {
 
       RegisterInfoMapPointer _registerMapping;
       
-      // Bar contents with shared-memory compatible vector type. Plain pointers are used here since this is what we
-      // get from the shared memory allocation.
-      std::map<uint8_t, SharedMemoryVector*> _barContents;
+      /** Notification channel of a bar in the shared memory, used to implement AccessMode::wait_for_new_data across
+       *  processes. Each write increments the write counter and stores the written word range in the ring buffer entry
+       *  of its count. Waiting threads of all processes sleep on the counter as a futex (on other platforms than Linux
+       *  they poll it) and check the ring buffer entries of the new counts for their register. If they have fallen
+       *  behind by more than the ring buffer size, they assume that their register has been written. */
+      struct WriteNotification {
+        static const uint32_t nRanges = 64;
+        std::atomic<uint32_t> writeCount;
+        /// number of threads waiting on writeCount, so writers only issue the wake-up call if needed
+        std::atomic<uint32_t> nWaiters;
+        /// written ranges as word indices: first word in the upper and end (exclusive) in the lower 32 bits
+        std::atomic<uint64_t> ranges[nRanges];
+      };
+
+      /** A bar in the shared memory. The contents are a plain array of words in the segment. Each bar also has a
+       *  sequence counter in the segment, which implements a seqlock between all processes: a writer increments it to
+       *  an odd value before modifying the bar and to the next even value afterwards. Readers copy the data and retry
+       *  if the counter has changed in the meantime, they never block writers.
+       *  Writers exclude each other by storing their process id as owner of the bar. If a process dies while owning a
+       *  bar, the next reader or writer finds the owner gone, completes the aborted write (the bar contents might be
+       *  partially written) and releases the bar.
+       *  The pointers are only valid in this process. */
+      struct SharedBar {
+        int32_t *data{nullptr};
+        size_t sizeInWords{0};
+        std::atomic<uint32_t> *sequence{nullptr};
+        std::atomic<pid_t> *owner{nullptr};
+        WriteNotification *notification{nullptr};
+      };
+
+      /// The bars by their number. Entries of bars which do not exist have no data.
+      std::array<SharedBar, 256> _bars;
       
       // Bar sizes
       std::map<uint8_t, size_t> _barSizesInBytes;
@@ -72,56 +105,21 @@ namespace ChimeraTK {
       public:
         SharedMemoryManager(SharedDummyBackend &sharedDummyBackend_,
                             const std::string instanceId,
-                            const std::string mapFileName) :
-          sharedDummyBackend(sharedDummyBackend_),
-          mapFileHash(std::to_string(std::hash<std::string>{}(mapFileName))),
-          instanceIdHash(std::to_string(std::hash<std::string>{}(instanceId))),
-          name("ChimeraTK_SharedDummy_"+mapFileHash+"_"+instanceIdHash),
-          segment(boost::interprocess::open_or_create, name.c_str(), getRequiredMemoryWithOverhead()),
-          alloc_inst(segment.get_segment_manager()),
-          globalMutex(boost::interprocess::open_or_create, name.c_str())
-        {
-          // lock guard with the interprocess mutex
-          std::lock_guard<boost::interprocess::named_mutex> lock(globalMutex);
-
-          // find the use counter
-          auto res = segment.find<size_t>("UseCounter");
-          if(res.second != 1) {  // if not found: create it
-            useCount = segment.construct<size_t>("UseCounter")(0);
-          }
-          else {
-            useCount = res.first;
-          }
-
-          // increment use counter
-          (*useCount)++;
-
-#ifdef _DEBUG
-          std::cout << "Created shared memory with a size of " << segment.get_size() << " bytes." << std::endl;
-          std::cout << "    Free space : " << segment.get_free_memory() << std::endl;
-          std::cout << "    useCount is: " << *useCount << std::endl << std::flush;
-#endif
-        }
+                            const std::string mapFileName,
+                            const std::string segmentDirectory_);
+
+        ~SharedMemoryManager();
 
-        ~SharedMemoryManager() {
-
-          // lock guard with the interprocess mutex
-          std::lock_guard<boost::interprocess::named_mutex> lock(globalMutex);
-          
-          // decrement use counter
-          (*useCount)--;
-          
-          // if use count at 0, destroy shared memory and the interprocess mutex
-          if(*useCount == 0) {
-            boost::interprocess::shared_memory_object::remove(name.c_str());
-            boost::interprocess::named_mutex::remove(name.c_str());
-          }
-        }
-        
         /**
-         * Finds or constructs a vector object in the shared memory.
+         * Finds or constructs the contents, the sequence counter, the owner and the notification channel of all bars in
+         * the shared memory.
+         *
+         * If the segment is too small, it is grown. Since the allocated objects keep their offsets, processes which
+         * have mapped the segment before can continue to use their bars. Growing and constructing is done under the
+         * global mutex, and a process which finds the segment grown by another process remaps it before accessing
+         * the segment manager, because new objects might lie outside its old mapping.
          */
-        SharedMemoryVector* findOrConstructVector(const std::string& objName, const size_t size);
+        void setupBars(std::array<SharedBar, 256> &bars);
 
         /**
          * Get information on the shared memory segment
@@ -131,14 +129,24 @@ namespace ChimeraTK {
 
       private:
 
+        typedef boost::interprocess::managed_shared_memory::segment_manager SegmentManager;
+
         // Constants to take overhead of managed shared memory into respect
         // (approx. linear function, evaluated using Boost 1.58)
         // TODO Adjust for additional overhead (PIDs, ...)
         static const size_t SHARED_MEMORY_CONST_OVERHEAD = 1000;
-        static const size_t SHARED_MEMORY_OVERHEAD_PER_VECTOR = 80;
+        // each bar consists of four named objects: the contents, the sequence counter, the owner and the notification
+        // channel
+        static const size_t SHARED_MEMORY_OVERHEAD_PER_BAR = 4*80 + sizeof(WriteNotification);
 
         SharedDummyBackend& sharedDummyBackend;
 
+        // Directory of the file backing the segment (e.g. a hugetlbfs mount), empty for POSIX shared memory
+        std::string segmentDirectory;
+
+        // Sizes of the segment are multiples of this (the huge page size on hugetlbfs)
+        size_t pageSize;
+
         // Hashes to assure match of shared memory accessing processes
         std::string mapFileHash;
         std::string instanceIdHash;
@@ -146,20 +154,38 @@ namespace ChimeraTK {
         // the name of the segment
         std::string name;
 
-        // the shared memory segment
-        boost::interprocess::managed_shared_memory segment;
-
-        // the allocator instance
-        const ShmemAllocator alloc_inst;
-        
-        // global (interprocess) mutex
+        // global (interprocess) mutex, protecting the use count and the layout of the segment
         boost::interprocess::named_mutex globalMutex;
 
+        // the shared memory segment, only one of them is mapped depending on segmentDirectory
+        boost::interprocess::managed_shared_memory sharedMemorySegment;
+        boost::interprocess::managed_mapped_file fileSegment;
+
+        // the segment manager of the mapped segment and the segment size at the time of mapping
+        SegmentManager *segmentManager{nullptr};
+        size_t mappedSize{0};
+
         // pointer to the use count on shared memory;
         size_t *useCount{nullptr};
 
         size_t getRequiredMemoryWithOverhead();
 
+        SharedBar findOrConstructBar(const std::string& barName, const size_t sizeInWords);
+
+        /// Map the segment in its current size, creating it if it does not exist, and find the use count. The global
+        /// mutex must be held.
+        void mapSegment();
+
+        /// Enlarge the segment for all processes and remap it. The global mutex must be held.
+        void growSegment(size_t extraBytes);
+
+        /// Determine the page size for the segment, also checks that the directory is accessible
+        static size_t getPageSize(const std::string &segmentDirectory);
+
+        std::string getSegmentFileName() const;
+
+        size_t roundUpToPageSize(size_t size) const;
+
       };  /* class SharedMemoryManager */
       
       // Managed shared memory object
@@ -174,6 +200,16 @@ namespace ChimeraTK {
 
       static void checkSizeIsMultipleOfWordSize(size_t sizeInBytes);
 
+      /// Check that the address range lies inside the bar and return the bar
+      SharedBar& getBar(uint8_t bar, uint32_t address, size_t sizeInBytes);
+
+      /// Become the owner of the bar for a write, waiting for the current owner if necessary
+      static void lockBar(SharedBar &bar);
+
+      /** Called by readers and writers which have been retrying to access the bar for a while. Releases the bar if
+       *  its owner has died and throws if the bar could not be accessed within the timeout. */
+      static void handleBusyBar(SharedBar &bar, std::chrono::steady_clock::time_point firstAttempt);
+
       static std::string convertPathRelativeToDmapToAbs(std::string const & mapfileName);
 
       /** map of instance names and pointers to allow re-connecting to the same instance with multiple Devices */
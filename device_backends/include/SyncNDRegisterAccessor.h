@@ -8,6 +8,9 @@
 #ifndef CHIMERA_TK_SYNC_N_D_REGISTER_ACCESSOR_H
 #define CHIMERA_TK_SYNC_N_D_REGISTER_ACCESSOR_H
 
+#include <functional>
+#include <mutex>
+
 #include <boost/make_shared.hpp>
 
 #include "ForwardDeclarations.h"
@@ -16,11 +19,13 @@
 #include "DeviceException.h"
 #include "ExperimentalFeatures.h"
 #include "NDRegisterAccessor.h"
+#include "ReadAsyncThreadPool.h"
 
 namespace ChimeraTK {
 
   /** NDRegisterAccessor for backends with only synchronous transfers (so readAsync() must be implemented with a
-   *  thread). This class just provides a default implementation of readAsync() for those backends. */
+   *  thread). This class just provides a default implementation of readAsync() for those backends. The transfers are
+   *  executed by the persistent worker threads of the ReadAsyncThreadPool. */
   template<typename UserType>
   class SyncNDRegisterAccessor : public NDRegisterAccessor<UserType> {
 
@@ -28,7 +33,8 @@ namespace ChimeraTK {
       SyncNDRegisterAccessor(std::string const &name,
                              std::string const &unit = std::string(TransferElement::unitNotSet),
                              std::string const &description = std::string())
-      : NDRegisterAccessor<UserType>(name, unit, description)
+      : NDRegisterAccessor<UserType>(name, unit, description),
+        readAsyncTask([this] { readAsyncTransfer(); })
       {}
 
       ~SyncNDRegisterAccessor() {
@@ -41,46 +47,82 @@ namespace ChimeraTK {
        * constructors before throwing an exception (hint: put catch-all block around the entired constructor, call
        * shutdown() there and then rethrow the exception).
        *
-       * Implementation note: This function call is necessary to ensure that a potentially still-running thread
-       * launched in readAsync() is properly terminated before destroying the accessor object. Since this thread
+       * Implementation note: This function call is necessary to ensure that a potentially still-running transfer
+       * started in readAsync() is properly terminated before destroying the accessor object. Since this transfer
        * accesses virtual functions like doReadTransfer(), the full accessor object must still be alive, thus shutting
        * down the thread in the base class destructor is too late. Technically, implementations overriding readAsync()
        * would not need to call this function, but to make sure all implementations which do not override readAsync()
        * actually call it, the function call is enforced for all implementations in the destructor with an assert.
        */
       void shutdown() {
-        if(readAsyncThread.joinable()) {
-          readAsyncThread.interrupt();
-          readAsyncThread.join();
-        }
+        ReadAsyncThreadPool::getInstance().cancel(readAsyncTask);
         shutdownCalled = true;
       }
 
       TransferFuture doReadTransferAsync() {
-        // create promise future pair and launch doReadTransfer in separate thread
-        readAsyncPromise = TransferFuture::PromiseType();
-        auto boostFuture = readAsyncPromise.get_future().share();
-        readAsyncThread = boost::thread(
-          [this] {
-            this->doReadTransfer();
-            // Do not call postRead() here. This thread is not allowed to touch the user space buffers.
-            // postRead() will be called in the user thread in TransferFuture::wait().
-            transferFutureData._versionNumber = VersionNumber();
-            readAsyncPromise.set_value(&transferFutureData);
-          }
-        );
+        // re-arm the promise and let the thread pool execute doReadTransfer
+        readAsyncPromise.reset();
+        ReadAsyncThreadPool::getInstance().submit(readAsyncTask);
 
         // form TransferFuture, store it for later re-used and return it
-        return TransferFuture(boostFuture, this);
+        return TransferFuture(readAsyncPromise, this);
+      }
+
+      bool setReadyListener(std::function<void()> listener) override {
+        std::lock_guard<std::mutex> lock(readyListenerMutex);
+        readyListener = std::move(listener);
+        return true;
+      }
+
+    protected:
+
+      /** Set the key used by the ReadAsyncThreadPool to keep transfers of the same backend on the same worker
+       *  thread. Implementations should pass the backend in their constructor. Must not be called while a readAsync()
+       *  transfer is running. */
+      void setReadAsyncAffinity(const void *backend) {
+        readAsyncTask.setAffinity(backend);
       }
 
     private:
 
-      /// Thread which might be launched in readAsync()
-      boost::thread readAsyncThread;
+      /** Executed in a thread of the ReadAsyncThreadPool for readAsync() */
+      void readAsyncTransfer() {
+        try {
+          this->doReadTransfer();
+        }
+        catch(boost::thread_interrupted&) {
+          // shutdown() has been called: leave the future unfulfilled, nobody will wait for it any more
+          throw;
+        }
+        catch(...) {
+          readAsyncPromise.setException(boost::current_exception());
+          notifyReadyListener();
+          return;
+        }
+        // Do not call postRead() here. This thread is not allowed to touch the user space buffers.
+        // postRead() will be called in the user thread in TransferFuture::wait().
+        transferFutureData._versionNumber = VersionNumber();
+        readAsyncPromise.setValue(&transferFutureData);
+        notifyReadyListener();
+      }
+
+      /** Call the listener registered with setReadyListener(), if any */
+      void notifyReadyListener() {
+        std::lock_guard<std::mutex> lock(readyListenerMutex);
+        if(readyListener) readyListener();
+      }
+
+      /// Task executed by the ReadAsyncThreadPool in readAsync()
+      ReadAsyncThreadPool::Task readAsyncTask;
+
+      /// Listener registered with setReadyListener(), called after each completed readAsync() transfer
+      std::function<void()> readyListener;
+
+      /// Mutex protecting readyListener, held while the listener is called
+      std::mutex readyListenerMutex;
 
-      /// Promise used in readAsync()
-      TransferFuture::PromiseType readAsyncPromise;
+      /// Promise used in readAsync(), re-armed for each transfer
+      TransferFuture::ReusablePromise readAsyncPromise;
 
       /// Data transferred in the TransferFuture
       TransferFuture::Data transferFutureData{{}};
@@ -30,6 +30,7 @@
 
 namespace ChimeraTK {
   class PersistentDataStorage;
+  class DeviceBackend;
 }
 
 namespace ChimeraTK {
@@ -38,6 +39,18 @@ namespace ChimeraTK {
 
   using ChimeraTK::TransferFuture;
 
+  /** Function executing the given function object, e.g. by posting it into an event loop. The asynchronous transfer
+   *  functions with completion handlers use it to call the handler in the context chosen by the application. */
+  typedef std::function<void(std::function<void()>)> TransferExecutor;
+
+  /** Completion handler for TransferElement::readAsync(). The argument is empty on success, otherwise it holds the
+   *  exception which occurred during the transfer. */
+  typedef std::function<void(boost::exception_ptr)> ReadCompletionHandler;
+
+  /** Completion handler for TransferElement::writeAsync(). The first argument is the return value of write(), the
+   *  second argument is empty on success, otherwise it holds the exception which occurred during the transfer. */
+  typedef std::function<void(bool, boost::exception_ptr)> WriteCompletionHandler;
+
   /*******************************************************************************************************************/
 
   /** Base class for register accessors which can be part of a TransferGroup */
@@ -182,6 +195,43 @@ namespace ChimeraTK {
         return activeFuture;
       }
 
+      /** Return a file descriptor which becomes readable when new data has arrived, to integrate the TransferElement
+       *  into event loops based on poll() or epoll. An asynchronous transfer is started with readAsync() if none is
+       *  active, and the handle becomes readable when its TransferFuture is ready. The new data is then obtained e.g.
+       *  with readNonBlocking(); the next call to this function (or readAsync()) starts the next transfer and resets
+       *  the handle.
+       *
+       *  The file descriptor stays the same for all transfers of this TransferElement, so it needs to be registered
+       *  with the event loop only once. It must neither be read from nor closed by the caller. Returns -1 if the
+       *  implementation does not support wait handles (see TransferFuture::getWaitHandle()).
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      int getWaitHandle() {
+        return readAsync().getWaitHandle();
+      }
+
+      /** Read data asynchronously and call the handler through the executor once the transfer has completed. When the
+       *  handler is called, the new data is already in the user buffer (i.e. TransferFuture::wait() has been called).
+       *  Other than with readAsync(), no thread needs to wait for the transfer, so many transfers can be handled in
+       *  a single thread, e.g. in an event loop or by coroutines resumed from the handler.
+       *
+       *  The TransferElement must be owned by a boost::shared_ptr. If it is destroyed before the transfer has
+       *  completed, the handler is not called.
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      void readAsync(TransferExecutor executor, ReadCompletionHandler handler);
+
+      /** Write data asynchronously and call the handler through the executor once the transfer has completed. The
+       *  data is taken from the user buffer in this function (i.e. preWrite() is called here), so the buffer can be
+       *  modified right after it returns. The transfer itself is executed in the ReadAsyncThreadPool. The
+       *  TransferElement is kept alive until the handler has been called.
+       *
+       *  The TransferElement must be owned by a boost::shared_ptr. Only one write may be in progress at a time.
+       *
+       *  Note: This feature is still experimental. Expect API changes without notice! */
+      void writeAsync(TransferExecutor executor, WriteCompletionHandler handler,
+          ChimeraTK::VersionNumber versionNumber={});
+
       /** Write the data to device. The return value is true, old data was lost on the write transfer (e.g. due to an
        *  buffer overflow). In case of an unbuffered write transfer, the return value will always be false. */
       bool write(ChimeraTK::VersionNumber versionNumber={}) {
@@ -207,6 +257,27 @@ namespace ChimeraTK {
         return ChimeraTK::VersionNumber();
       }
 
+      /** Returns the number of values which did not fit into the UserType and have been saturated in the last read
+       *  transfer. This is only counted if the accessor was obtained with AccessMode::saturate, otherwise (and for
+       *  transfer elements without conversion) 0 is returned. */
+      virtual size_t getNumberOfOverflows() const {
+        return 0;
+      }
+
+      /** Check whether reads wait until new data has been written to the register (AccessMode::wait_for_new_data).
+       *  Such elements cannot be added to a TransferGroup, since it transfers the hardware-accessing elements directly
+       *  and hence cannot wait. */
+      virtual bool isWaitingForNewData() const {
+        return false;
+      }
+
+      /** Return the backend accessed by this element, or nullptr if unknown. Only meaningful for hardware-accessing
+       *  elements. The TransferGroup uses it to transfer all elements of the same backend in one thread in a defined
+       *  order. */
+      virtual const DeviceBackend* getTransferBackend() const {
+        return nullptr;
+      }
+
       /** Check if transfer element is read only, i\.e\. it is readable but not writeable. */
       virtual bool isReadOnly() const = 0;
 
@@ -291,6 +362,18 @@ namespace ChimeraTK {
        *  the thread execution. */
       virtual void transferFutureWaitCallback() {};
 
+      /** Register a function which is called each time an asynchronous transfer started by readAsync() has completed,
+       *  i.e. right after the TransferFuture became ready. The function may be called from any thread and must
+       *  return quickly. Pass an empty function to remove the listener; after this function returns, no call to a
+       *  previously registered listener is still in progress. Only one listener can be registered at a time.
+       *
+       *  Returns false if the implementation does not support notifying listeners, in which case the listener is not
+       *  registered. Decorators should pass this on to their target. This is used by the ReadAnyGroup. */
+      virtual bool setReadyListener(std::function<void()> listener) {
+        (void) listener; // prevent warning
+        return false;
+      }
+
       /** Transfer the data from the user buffer into the device send buffer, while converting the data from then
        *  user data format if needed.
        *
@@ -3,6 +3,9 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/types.h>
+#include <map>
+#include <vector>
 #include <boost/function.hpp>
 
 #include "NumericAddressedBackend.h"
@@ -50,10 +53,53 @@ namespace ChimeraTK {
       /** This function is the same for one or multiple words */
       void directRead(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes);
 
+      /// Flag whether the bars shall be memory mapped, see constructor
+      bool _useMmap;
+
+      /// Flag whether the device node is a regular file which is used as a stand-in for the device
+      bool _isFileStandIn;
+
+      /// Offsets of the bars in the address space of the device node, used for pread/pwrite and mmap. Only filled for
+      /// the pcieuni driver and for the file stand-in.
+      std::map<uint8_t, loff_t> _barOffsets;
+
+      /// A memory mapped bar
+      struct MappedBar {
+        volatile int32_t *base;
+        size_t sizeInBytes;
+
+        /** Check if the given range is inside the mapping and aligned to the word size */
+        bool contains(uint32_t address, size_t nBytes) const {
+          return base != nullptr && address % sizeof(int32_t) == 0 && nBytes % sizeof(int32_t) == 0 &&
+                 address + nBytes <= sizeInBytes;
+        }
+      };
+
+      /// Memory mappings of the bars, index is the bar number. Bars which are not mapped have a nullptr as base.
+      std::vector<MappedBar> _mappedBars;
+
+      /** Map all bars with known offset and size. Bars which cannot be mapped (e.g. because the driver does not
+       *  support mmap) are silently left unmapped, so the read/write system calls are used for them. */
+      void mapBars();
+      void unmapBars();
+
+      /** Configure the access to a regular file instead of a device node. The bars are stored consecutively in the
+       *  file, each with the size obtained from the map file rounded up to the page size. */
+      void configureFileStandIn();
+
+      std::map<uint8_t, size_t> getBarSizesInBytesFromRegisterMapping() const;
+
       /** constructor called through createInstance to create device object */
 
     public:
-      PcieBackend(std::string deviceNodeName, std::string mapFileName="");
+      /** Create the backend for the given device node. If useMmap is true, the bars are memory mapped when opening
+       *  the device and registers are accessed directly with load and store instructions instead of system calls.
+       *  This is only supported by the pcieuni driver. Bars which cannot be mapped are still accessed through system
+       *  calls. Since the size of the bars is taken from the map file, the bars are not mapped without map file.
+       *
+       *  If deviceNodeName is a regular file instead of a device node, the file is used as a stand-in for the device
+       *  memory (e.g. for tests without hardware). A map file is required in this case. */
+      PcieBackend(std::string deviceNodeName, std::string mapFileName="", bool useMmap=false);
       virtual ~PcieBackend();
 
       virtual void open();
@@ -62,6 +108,11 @@ namespace ChimeraTK {
       virtual void read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes);
       virtual void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes);
 
+      /** Check whether the bar is memory mapped, i.e. aligned accesses to it do not use system calls */
+      bool isBarMapped(uint8_t bar) const {
+        return bar < _mappedBars.size() && _mappedBars[bar].base != nullptr;
+      }
+
       virtual std::string readDeviceInfo();
 
       /*Host or parameters (at least for now) are just place holders as pcidevice does not use them*/
@@ -3,6 +3,8 @@
 #include <errno.h>
 #include <stdio.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sstream>
 #include <unistd.h>
 
@@ -19,13 +21,15 @@
 
 namespace ChimeraTK {
 
-  PcieBackend::PcieBackend(std::string deviceNodeName, std::string mapFileName)
+  PcieBackend::PcieBackend(std::string deviceNodeName, std::string mapFileName, bool useMmap)
   : NumericAddressedBackend(mapFileName),
     _deviceID(0),
     _ioctlPhysicalSlot(0),
     _ioctlDriverVersion(0),
     _ioctlDMA(0),
-    _deviceNodeName(deviceNodeName)
+    _deviceNodeName(deviceNodeName),
+    _useMmap(useMmap),
+    _isFileStandIn(false)
   {
   }
 
@@ -47,11 +51,95 @@ namespace ChimeraTK {
           PcieBackendException::EX_CANNOT_OPEN_DEVICE);
     }
 
-    determineDriverAndConfigureIoctl();
+    struct stat nodeStatus;
+    if (fstat(_deviceID, &nodeStatus) == 0 && S_ISREG(nodeStatus.st_mode)) {
+      configureFileStandIn();
+    }
+    else {
+      determineDriverAndConfigureIoctl();
+    }
+
+    if (_useMmap) {
+      mapBars();
+    }
 
     _opened = true;
   }
 
+  std::map<uint8_t, size_t> PcieBackend::getBarSizesInBytesFromRegisterMapping() const {
+    std::map<uint8_t, size_t> barSizesInBytes;
+    for (auto const &mapElement : *_registerMap) {
+      barSizesInBytes[mapElement.bar] = std::max(barSizesInBytes[mapElement.bar],
+          static_cast<size_t>(mapElement.address + mapElement.nBytes));
+    }
+    return barSizesInBytes;
+  }
+
+  void PcieBackend::configureFileStandIn() {
+    if (!_registerMap) {
+      ::close(_deviceID);
+      throw PcieBackendException("A map file is required to use the regular file " + _deviceNodeName +
+          " as a stand-in for a device", PcieBackendException::EX_UNSUPPORTED_DRIVER);
+    }
+    _isFileStandIn = true;
+
+    // lay out the bars consecutively, each starting at a page boundary so it can be mapped
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    loff_t fileSize = 0;
+    _barOffsets.clear();
+    for (auto const &barSize : getBarSizesInBytesFromRegisterMapping()) {
+      _barOffsets[barSize.first] = fileSize;
+      fileSize += (barSize.second + pageSize - 1) / pageSize * pageSize;
+    }
+
+    // grow the file if needed, so all bars are backed by the file
+    struct stat fileStatus;
+    if (fstat(_deviceID, &fileStatus) != 0 ||
+        (fileStatus.st_size < fileSize && ftruncate(_deviceID, fileSize) != 0)) {
+      std::string errorMessage = createErrorStringWithErrnoText("Cannot resize device stand-in file: ");
+      ::close(_deviceID);
+      throw PcieBackendException(errorMessage, PcieBackendException::EX_CANNOT_OPEN_DEVICE);
+    }
+
+    _readDMAFunction =
+        boost::bind(&PcieBackend::directRead, this, _1, _2, _3, _4);
+    _writeFunction =
+        boost::bind(&PcieBackend::directWrite, this, _1, _2, _3, _4);
+    _readFunction =
+        boost::bind(&PcieBackend::directRead, this, _1, _2, _3, _4);
+  }
+
+  void PcieBackend::mapBars() {
+    // without map file the bar sizes are unknown, so all accesses go through the system calls
+    if (!_registerMap) {
+      return;
+    }
+    for (auto const &barSize : getBarSizesInBytesFromRegisterMapping()) {
+      auto barOffset = _barOffsets.find(barSize.first);
+      if (barOffset == _barOffsets.end() || barSize.second == 0) {
+        continue;
+      }
+      void *base = mmap(nullptr, barSize.second, PROT_READ | PROT_WRITE, MAP_SHARED, _deviceID, barOffset->second);
+      if (base == MAP_FAILED) {
+        // not supported for this bar: keep using the system calls
+        continue;
+      }
+      if (_mappedBars.size() <= barSize.first) {
+        _mappedBars.resize(barSize.first + 1, MappedBar{nullptr, 0});
+      }
+      _mappedBars[barSize.first] = MappedBar{static_cast<volatile int32_t*>(base), barSize.second};
+    }
+  }
+
+  void PcieBackend::unmapBars() {
+    for (auto &mappedBar : _mappedBars) {
+      if (mappedBar.base != nullptr) {
+        munmap(const_cast<int32_t*>(mappedBar.base), mappedBar.sizeInBytes);
+      }
+    }
+    _mappedBars.clear();
+  }
+
   void PcieBackend::determineDriverAndConfigureIoctl() {
     // determine the driver by trying the physical slot ioctl
     device_ioctrl_data ioctlData = { 0, 0, 0, 0 };
@@ -89,6 +177,10 @@ namespace ChimeraTK {
       _ioctlPhysicalSlot = PCIEUNI_PHYSICAL_SLOT;
       _ioctlDriverVersion = PCIEUNI_DRIVER_VERSION;
       _ioctlDMA = PCIEUNI_READ_DMA;
+      _barOffsets.clear();
+      for (uint8_t bar = 0; bar < 6; ++bar) {
+        _barOffsets[bar] = PCIEUNI_BAR_OFFSETS[bar];
+      }
       _readDMAFunction =
           boost::bind(&PcieBackend::readDMAViaIoctl, this, _1, _2, _3, _4);
       _writeFunction =
@@ -110,8 +202,10 @@ namespace ChimeraTK {
 
   void PcieBackend::close() {
     if (_opened) {
+      unmapBars();
       ::close(_deviceID);
     }
+    _isFileStandIn = false;
     _opened = false;
   }
 
@@ -140,12 +234,13 @@ namespace ChimeraTK {
     if (_opened == false) {
       throw PcieBackendException("Device closed", PcieBackendException::EX_DEVICE_CLOSED);
     }
-    if (bar > 5) {
+    auto barOffset = _barOffsets.find(bar);
+    if (barOffset == _barOffsets.end()) {
       std::stringstream errorMessage;
-      errorMessage << "Invalid bar number: " << bar << std::endl;
+      errorMessage << "Invalid bar number: " << static_cast<int>(bar) << std::endl;
       throw PcieBackendException(errorMessage.str(), PcieBackendException::EX_READ_ERROR);
     }
-    loff_t virtualOffset = PCIEUNI_BAR_OFFSETS[bar] + address;
+    loff_t virtualOffset = barOffset->second + address;
 
     if (pread(_deviceID, data, sizeInBytes, virtualOffset) !=
         static_cast<int>(sizeInBytes)) {
@@ -179,12 +274,13 @@ namespace ChimeraTK {
     if (_opened == false) {
       throw PcieBackendException("Device closed", PcieBackendException::EX_DEVICE_CLOSED);
     }
-    if (bar > 5) {
+    auto barOffset = _barOffsets.find(bar);
+    if (barOffset == _barOffsets.end()) {
       std::stringstream errorMessage;
-      errorMessage << "Invalid bar number: " << bar << std::endl;
+      errorMessage << "Invalid bar number: " << static_cast<int>(bar) << std::endl;
       throw PcieBackendException(errorMessage.str(), PcieBackendException::EX_WRITE_ERROR);
     }
-    loff_t virtualOffset = PCIEUNI_BAR_OFFSETS[bar] + address;
+    loff_t virtualOffset = barOffset->second + address;
 
     if (pwrite(_deviceID, data, sizeInBytes, virtualOffset) !=
         static_cast<int>(sizeInBytes)) {
@@ -207,7 +303,13 @@ namespace ChimeraTK {
 
   void PcieBackend::read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes)
   {
-    if(bar != 0xD) {
+    if(bar < _mappedBars.size() && _mappedBars[bar].contains(address, sizeInBytes)) {
+      volatile int32_t const *source = _mappedBars[bar].base + address/sizeof(int32_t);
+      for(size_t i = 0; i < sizeInBytes/sizeof(int32_t); ++i) {
+        data[i] = source[i];
+      }
+    }
+    else if(bar != 0xD) {
       _readFunction(bar, address, data, sizeInBytes);
     }
     else {
@@ -229,6 +331,13 @@ namespace ChimeraTK {
   }
 
   void PcieBackend::write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes) {
+    if(bar < _mappedBars.size() && _mappedBars[bar].contains(address, sizeInBytes)) {
+      volatile int32_t *target = _mappedBars[bar].base + address/sizeof(int32_t);
+      for(size_t i = 0; i < sizeInBytes/sizeof(int32_t); ++i) {
+        target[i] = data[i];
+      }
+      return;
+    }
     _writeFunction(bar, address, data, sizeInBytes);
   }
 
@@ -300,6 +409,10 @@ namespace ChimeraTK {
 
   std::string PcieBackend::readDeviceInfo() {
     std::ostringstream os;
+    if (_isFileStandIn) {
+      os << "FILE STAND-IN: " << _deviceNodeName;
+      return os.str();
+    }
     device_ioctrl_data ioctlData = { 0, 0, 0, 0 };
     if (ioctl(_deviceID, _ioctlPhysicalSlot, &ioctlData) < 0) {
       throw PcieBackendException(createErrorStringWithErrnoText("Cannot read device info: "),
@@ -325,7 +438,19 @@ namespace ChimeraTK {
       std::string instance,
       std::list<std::string> parameters, std::string mapFileName){
 
-    // there is only one possible parameter, a map file. It is optional
+    // the keyword "mmap" enables the memory mapped access to the bars. It is optional and can be given at any position.
+    bool useMmap = false;
+    for (auto parameter = parameters.begin(); parameter != parameters.end(); ) {
+      if (*parameter == "mmap") {
+        useMmap = true;
+        parameter = parameters.erase(parameter);
+      }
+      else {
+        ++parameter;
+      }
+    }
+
+    // there is only one other possible parameter, a map file. It is optional
     if (parameters.size() == 1){
       // in case the map file is coming from the URI the mapFileName string from the third dmap file column should be empty
       if (mapFileName.empty()){
@@ -343,7 +468,7 @@ namespace ChimeraTK {
       }
     }
 
-    return boost::shared_ptr<DeviceBackend> (new PcieBackend("/dev/"+instance, mapFileName));
+    return boost::shared_ptr<DeviceBackend> (new PcieBackend("/dev/"+instance, mapFileName, useMmap));
   }
 
 } // namespace ChimeraTK
@@ -0,0 +1,27 @@
+#ifndef CHIMERATK_ATOMIC_WORD_COPY_H
+#define CHIMERATK_ATOMIC_WORD_COPY_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ChimeraTK{
+
+  /** Copy words from or to memory which is protected by a sequence counter. Readers of a seqlock copy the data while a
+   *  writer might modify it, so a plain memcpy would be a data race even though an inconsistent copy is discarded.
+   *  Each word is copied with a relaxed atomic load and store instead, which compiles to plain moves.
+   *  The bars are plain int32_t arrays (register contents are handed out by reference), hence the GCC builtins
+   *  instead of std::atomic. */
+  inline void atomicWordCopy(int32_t *destination, const int32_t *source, size_t nWords){
+    for (size_t i = 0; i < nWords; ++i){
+      __atomic_store_n(destination + i, __atomic_load_n(source + i, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+  }
+
+  /** Store a single word with a relaxed atomic store, see atomicWordCopy(). */
+  inline void atomicWordStore(int32_t *destination, int32_t value){
+    __atomic_store_n(destination, value, __ATOMIC_RELAXED);
+  }
+
+}
+
+#endif // CHIMERATK_ATOMIC_WORD_COPY_H
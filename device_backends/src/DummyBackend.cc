@@ -1,26 +1,16 @@
 #include <algorithm>
 #include <sstream>
+#include <thread>
+#include <typeinfo>
 #include <boost/lambda/lambda.hpp>
 
 #include "DummyBackend.h"
+#include "AtomicWordCopy.h"
 #include "NotImplementedException.h"
 #include "MapFileParser.h"
 #include "parserUtilities.h"
 #include "BackendFactory.h"
 
-//macro to avoid code duplication
-#define TRY_REGISTER_ACCESS(COMMAND)\
-    try{\
-      COMMAND\
-    }catch( std::out_of_range & outOfRangeException ){\
-      std::stringstream errorMessage;\
-      errorMessage << "Invalid address offset " << address \
-      << " in bar " << static_cast<int>(bar) << "."	\
-      << "Caught out_of_range exception: " << outOfRangeException.what();\
-      throw DummyBackendException(errorMessage.str(), DummyBackendException::INVALID_ADDRESS);\
-    }
-
-
 namespace ChimeraTK {
   // Valid bar numbers are 0 to 5 , so they must be contained
   // in three bits.
@@ -63,6 +53,7 @@ namespace ChimeraTK {
       //the size of the vector is in words, not in bytes -> convert fist
       _barContents[barSizeInBytesIter->first].resize(
           barSizeInBytesIter->second / sizeof(int32_t), 0);
+      _bars[barSizeInBytesIter->first].contents = &_barContents[barSizeInBytesIter->first];
     }
   }
 
@@ -84,26 +75,83 @@ namespace ChimeraTK {
       throw DummyBackendException("Device is already closed.", DummyBackendException::ALREADY_CLOSED);
     }
 
-    _readOnlyAddresses.clear();
+    _readOnlyRanges.clear();
     _writeCallbackFunctions.clear();
+    _writeCallbackIndex.clear();
     _opened=false;
   }
 
   void DummyBackend::writeRegisterWithoutCallback(uint8_t bar, uint32_t address, int32_t data){
     std::lock_guard<std::mutex> lock(mutex);
-    TRY_REGISTER_ACCESS( _barContents[bar].at(address/sizeof(int32_t)) = data; );
+    int32_t *barData = getBarData(bar, address, sizeof(int32_t));
+    beginBarWrite(bar);
+    atomicWordStore(barData, data);
+    endBarWrite(bar);
   }
 
   void DummyBackend::read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes){
-    std::lock_guard<std::mutex> lock(mutex);
     if (!_opened){
       throw DummyBackendException("Device is closed.", DeviceException::NOT_OPENED);
     }
+    readInternal(bar, address, data, sizeInBytes);
+  }
+
+  void DummyBackend::readv(const std::vector<TransferRange> &ranges){
+    // Derived classes might override read(), e.g. to inject failures, so only the DummyBackend itself bypasses it.
+    if (typeid(*this) != typeid(DummyBackend)){
+      NumericAddressedBackend::readv(ranges);
+      return;
+    }
+    if (!_opened){
+      throw DummyBackendException("Device is closed.", DeviceException::NOT_OPENED);
+    }
+    for (auto &range : ranges){
+      readInternal(range.bar, range.address, range.data, range.sizeInBytes);
+    }
+  }
+
+  void DummyBackend::readInternal(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes){
     checkSizeIsMultipleOfWordSize( sizeInBytes );
-    unsigned int wordBaseIndex = address/sizeof(int32_t);
-    for (unsigned int wordIndex = 0; wordIndex < sizeInBytes/sizeof(int32_t); ++wordIndex){
-      TRY_REGISTER_ACCESS( data[wordIndex] = _barContents[bar].at(wordBaseIndex+wordIndex); );
+    const int32_t *barData = getBarData(bar, address, sizeInBytes);
+    std::atomic<uint32_t> &sequence = _bars[bar].sequence;
+
+    // Copy the data and retry if a write has modified the bar in the meantime. The copy might be inconsistent while
+    // a write is in progress, but it is only used if the sequence counter has not changed.
+    while(true) {
+      uint32_t sequenceBefore = sequence.load(std::memory_order_acquire);
+      if(sequenceBefore & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      atomicWordCopy(data, barData, sizeInBytes/sizeof(int32_t));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(sequence.load(std::memory_order_relaxed) == sequenceBefore) return;
+    }
+  }
+
+  int32_t* DummyBackend::getBarData(uint8_t bar, uint32_t address, size_t sizeInBytes){
+    std::vector<int32_t> *contents = _bars[bar].contents;
+    // the address is truncated to full words
+    size_t wordBaseIndex = address/sizeof(int32_t);
+    if (contents == nullptr || wordBaseIndex + sizeInBytes/sizeof(int32_t) > contents->size()){
+      std::stringstream errorMessage;
+      errorMessage << "Invalid address offset " << address << " in bar " << static_cast<int>(bar)
+                   << " for an access of " << sizeInBytes << " bytes.";
+      throw DummyBackendException(errorMessage.str(), DummyBackendException::INVALID_ADDRESS);
     }
+    return contents->data() + wordBaseIndex;
+  }
+
+  void DummyBackend::beginBarWrite(uint8_t bar){
+    std::atomic<uint32_t> &sequence = _bars[bar].sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // the data must not be modified before the odd sequence counter is visible
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void DummyBackend::endBarWrite(uint8_t bar){
+    std::atomic<uint32_t> &sequence = _bars[bar].sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
   }
 
   void DummyBackend::write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes){
@@ -112,20 +160,70 @@ namespace ChimeraTK {
       if (!_opened){
         throw DummyBackendException("Device is closed.", DeviceException::NOT_OPENED);
       }
-      checkSizeIsMultipleOfWordSize( sizeInBytes );
-      unsigned int wordBaseIndex = address/sizeof(int32_t);
-      for (unsigned int wordIndex = 0; wordIndex < sizeInBytes/sizeof(int32_t); ++wordIndex){
-        if (isReadOnly( bar, address + wordIndex*sizeof(int32_t) ) ){
-          continue;
-        }
-        TRY_REGISTER_ACCESS( _barContents[bar].at(wordBaseIndex+wordIndex) = data[wordIndex]; );
-      }
+      writeInternal(bar, address, data, sizeInBytes);
     }
     // we call the callback functions after releasing the mutex in order to
     // avoid the risk of deadlocks.
     runWriteCallbackFunctionsForAddressRange( AddressRange(bar, address, sizeInBytes ) );
   }
 
+  void DummyBackend::writev(const std::vector<TransferRange> &ranges){
+    // see readv()
+    if (typeid(*this) != typeid(DummyBackend)){
+      NumericAddressedBackend::writev(ranges);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!_opened){
+        throw DummyBackendException("Device is closed.", DeviceException::NOT_OPENED);
+      }
+      for (auto &range : ranges){
+        writeInternal(range.bar, range.address, range.data, range.sizeInBytes);
+      }
+    }
+    for (auto &range : ranges){
+      runWriteCallbackFunctionsForAddressRange( AddressRange(range.bar, range.address, range.sizeInBytes ) );
+    }
+  }
+
+  void DummyBackend::writeInternal(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes){
+    checkSizeIsMultipleOfWordSize( sizeInBytes );
+    int32_t *barData = getBarData(bar, address, sizeInBytes);
+    beginBarWrite(bar);
+
+    // Copy the gaps between the read-only ranges inside the written range. Word i is written to address + 4*i, which
+    // need not be aligned, so the range boundaries are converted into indices of the first word at or behind them.
+    size_t nWords = sizeInBytes/sizeof(int32_t);
+    uint64_t firstAddress = calculateVirtualAddress( address, bar );
+    auto firstWordAtOrBehind = [&]( uint64_t virtualAddress ) -> size_t {
+      if (virtualAddress <= firstAddress){
+        return 0;
+      }
+      return std::min<uint64_t>( nWords, (virtualAddress - firstAddress + sizeof(int32_t) - 1)/sizeof(int32_t) );
+    };
+    auto readOnlyRange = findReadOnlyRange( firstAddress );
+    if (readOnlyRange == _readOnlyRanges.end()){
+      readOnlyRange = _readOnlyRanges.upper_bound( firstAddress );
+    }
+    size_t gapStart = 0;
+    while (gapStart < nWords){
+      size_t gapEnd = nWords;
+      size_t nextGapStart = nWords;
+      if (readOnlyRange != _readOnlyRanges.end()){
+        gapEnd = firstWordAtOrBehind( readOnlyRange->first );
+        nextGapStart = firstWordAtOrBehind( readOnlyRange->second );
+        ++readOnlyRange;
+      }
+      if (gapEnd > gapStart){
+        atomicWordCopy(barData + gapStart, data + gapStart, gapEnd - gapStart);
+      }
+      gapStart = std::max( gapStart, nextGapStart );
+    }
+
+    endBarWrite(bar);
+  }
+
   std::string DummyBackend::readDeviceInfo(){
     std::stringstream info;
     info << "DummyBackend with mapping file " << _registerMapping->getMapFileName();
@@ -145,10 +243,23 @@ namespace ChimeraTK {
   }
 
   void DummyBackend::setReadOnly(uint8_t bar, uint32_t address,  size_t sizeInWords){
-    for (size_t i = 0; i < sizeInWords; ++i){
-      uint64_t virtualAddress = calculateVirtualAddress( address + i*sizeof(int32_t), bar );
-      _readOnlyAddresses.insert(virtualAddress);
+    if (sizeInWords == 0){
+      return;
+    }
+    uint64_t firstAddress = calculateVirtualAddress( address, bar );
+    uint64_t endAddress = firstAddress + sizeInWords*sizeof(int32_t);
+
+    // merge with all ranges which overlap or touch the new range
+    auto rangeIter = _readOnlyRanges.upper_bound( firstAddress );
+    if (rangeIter != _readOnlyRanges.begin() && std::prev(rangeIter)->second >= firstAddress){
+      --rangeIter;
+      firstAddress = rangeIter->first;
     }
+    while (rangeIter != _readOnlyRanges.end() && rangeIter->first <= endAddress){
+      endAddress = std::max( endAddress, rangeIter->second );
+      rangeIter = _readOnlyRanges.erase( rangeIter );
+    }
+    _readOnlyRanges[firstAddress] = endAddress;
   }
 
   void DummyBackend::setReadOnly( AddressRange addressRange ){
@@ -157,13 +268,50 @@ namespace ChimeraTK {
 
   bool  DummyBackend::isReadOnly( uint8_t bar, uint32_t address  ) const{
     uint64_t virtualAddress = calculateVirtualAddress( address, bar );
-    return (  _readOnlyAddresses.find(virtualAddress) != _readOnlyAddresses.end() );
+    return (  findReadOnlyRange(virtualAddress) != _readOnlyRanges.end() );
+  }
+
+  std::map< uint64_t, uint64_t >::const_iterator DummyBackend::findReadOnlyRange( uint64_t virtualAddress ) const{
+    auto rangeIter = _readOnlyRanges.upper_bound( virtualAddress );
+    if (rangeIter == _readOnlyRanges.begin()){
+      return _readOnlyRanges.end();
+    }
+    --rangeIter;
+    if (virtualAddress < rangeIter->second){
+      return rangeIter;
+    }
+    return _readOnlyRanges.end();
   }
 
   void  DummyBackend::setWriteCallbackFunction( AddressRange addressRange,
       boost::function<void(void)>  const & writeCallbackFunction ){
-    _writeCallbackFunctions.insert(
-        std::pair< AddressRange, boost::function<void(void)> >(addressRange, writeCallbackFunction) );
+    size_t callbackIndex = _writeCallbackFunctions.size();
+    _writeCallbackFunctions.push_back( WriteCallback{addressRange, writeCallbackFunction} );
+    if (addressRange.sizeInBytes == 0){
+      // can never be triggered
+      return;
+    }
+
+    uint64_t firstAddress = calculateVirtualAddress( addressRange.offset, addressRange.bar );
+    uint64_t endAddress = firstAddress + addressRange.sizeInBytes;
+    splitWriteCallbackSegment( firstAddress );
+    splitWriteCallbackSegment( endAddress );
+    for (auto segment = _writeCallbackIndex.find( firstAddress ); segment->first < endAddress; ++segment){
+      segment->second.push_back( callbackIndex );
+    }
+  }
+
+  void DummyBackend::splitWriteCallbackSegment( uint64_t virtualAddress ){
+    auto segment = _writeCallbackIndex.upper_bound( virtualAddress );
+    if (segment == _writeCallbackIndex.begin()){
+      _writeCallbackIndex[virtualAddress];
+      return;
+    }
+    --segment;
+    if (segment->first != virtualAddress){
+      // the new segment is covered by the same callbacks as the segment it is split from
+      _writeCallbackIndex.insert( segment, std::make_pair( virtualAddress, segment->second ) );
+    }
   }
 
   void  DummyBackend::runWriteCallbackFunctionsForAddressRange( AddressRange addressRange ){
@@ -177,24 +325,31 @@ namespace ChimeraTK {
 
   std::list< boost::function<void(void)> > DummyBackend::findCallbackFunctionsForAddressRange(
       AddressRange addressRange){
-    // as callback functions are not sortable, we want to loop the multimap only once.
     // FIXME: If the same function is registered more than one, it may be executed multiple times
-
-    // we only want the start address of the range, so we set size to 0
-    AddressRange firstAddressInBar(addressRange.bar, 0, 0);
-    AddressRange endAddress( addressRange.bar, addressRange.offset + addressRange.sizeInBytes, 0 );
-
-    std::multimap< AddressRange, boost::function<void(void)> >::iterator startIterator =
-        _writeCallbackFunctions.lower_bound( firstAddressInBar );
-
-    std::multimap< AddressRange, boost::function<void(void)> >::iterator endIterator =
-        _writeCallbackFunctions.lower_bound( endAddress );
-
     std::list< boost::function<void(void)> > returnList;
-    for( std::multimap< AddressRange, boost::function<void(void)> >::iterator callbackIter = startIterator;
-        callbackIter != endIterator; ++callbackIter){
-      if (isWriteRangeOverlap(callbackIter->first, addressRange) ){
-        returnList.push_back(callbackIter->second);
+    if (_writeCallbackFunctions.empty()){
+      return returnList;
+    }
+
+    // collect the callbacks of all segments overlapping the range
+    uint64_t firstAddress = calculateVirtualAddress( addressRange.offset, addressRange.bar );
+    uint64_t endAddress = firstAddress + addressRange.sizeInBytes;
+    auto segment = _writeCallbackIndex.upper_bound( firstAddress );
+    if (segment != _writeCallbackIndex.begin()){
+      --segment;
+    }
+    std::vector<size_t> callbackIndices;
+    for (; segment != _writeCallbackIndex.end() && segment->first < endAddress; ++segment){
+      callbackIndices.insert( callbackIndices.end(), segment->second.begin(), segment->second.end() );
+    }
+    // a callback covering several segments is executed only once, in the order of registration
+    std::sort( callbackIndices.begin(), callbackIndices.end() );
+    callbackIndices.erase( std::unique( callbackIndices.begin(), callbackIndices.end() ), callbackIndices.end() );
+
+    for (auto callbackIndex : callbackIndices){
+      WriteCallback &callback = _writeCallbackFunctions[callbackIndex];
+      if (isWriteRangeOverlap(callback.range, addressRange) ){
+        returnList.push_back(callback.function);
       }
     }
 
@@ -209,16 +364,18 @@ namespace ChimeraTK {
     uint32_t startAddress = std::max( firstRange.offset, secondRange.offset );
     uint32_t endAddress = std::min( firstRange.offset  + firstRange.sizeInBytes,
         secondRange.offset + secondRange.sizeInBytes );
-
-    // if at least one register is writable there is an overlap of writable registers
-    for ( uint32_t address = startAddress; address < endAddress; address += sizeof(int32_t) ){
-      if ( isReadOnly(firstRange.bar, address)==false ){
-        return true;
-      }
+    if (startAddress >= endAddress){
+      return false;
     }
 
-    // we looped all possible registers, none is writable
-    return false;
+    // Since read-only ranges are merged, the overlap is entirely read-only only if a single read-only range covers
+    // it. Otherwise at least one register can be written.
+    uint64_t virtualStartAddress = calculateVirtualAddress( startAddress, firstRange.bar );
+    auto readOnlyRange = findReadOnlyRange( virtualStartAddress );
+    if (readOnlyRange == _readOnlyRanges.end()){
+      return true;
+    }
+    return readOnlyRange->second < virtualStartAddress + (endAddress - startAddress);
   }
 
   boost::shared_ptr<DeviceBackend> DummyBackend::createInstance(std::string /*host*/,
@@ -58,6 +58,37 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  void NumericAddressedBackend::readv(const std::vector<TransferRange> &ranges) {
+    for(auto &range : ranges) {
+      read(range.bar, range.address, range.data, range.sizeInBytes);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void NumericAddressedBackend::writev(const std::vector<TransferRange> &ranges) {
+    for(auto &range : ranges) {
+      write(range.bar, range.address, range.data, range.sizeInBytes);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  uint32_t NumericAddressedBackend::getWriteCount(uint8_t /*bar*/) {
+    throw DeviceException("AccessMode::wait_for_new_data is not supported by this backend.",
+        DeviceException::NOT_IMPLEMENTED);
+  }
+
+  /********************************************************************************************************************/
+
+  bool NumericAddressedBackend::waitForWrite(uint8_t /*bar*/, uint32_t /*address*/, size_t /*sizeInBytes*/,
+      uint32_t &/*writeCount*/, bool /*blocking*/) {
+    throw DeviceException("AccessMode::wait_for_new_data is not supported by this backend.",
+        DeviceException::NOT_IMPLEMENTED);
+  }
+
+  /********************************************************************************************************************/
+
   void NumericAddressedBackend::read(const std::string &regModule, const std::string &regName,
       int32_t *data, size_t dataSize, uint32_t addRegOffset) {
 
@@ -140,7 +171,7 @@ namespace ChimeraTK {
     else {
       accessor = boost::shared_ptr< NDRegisterAccessor<UserType> >(
           new NumericAddressedBackendMuxedRegisterAccessor<UserType>(registerPathName, numberOfWords,
-              wordOffsetInRegister, shared_from_this()) );
+              wordOffsetInRegister, shared_from_this(), flags) );
     }
     // allow plugins to decorate the accessor and return it
     return decorateRegisterAccessor(registerPathName, accessor);
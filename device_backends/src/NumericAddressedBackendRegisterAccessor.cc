@@ -11,13 +11,16 @@ namespace ChimeraTK {
 
   template<>
   void NumericAddressedBackendRegisterAccessor<int32_t>::doPostRead() {
-    if(!isRaw) {
+    if(!_rawEqualsCooked) {
       auto itsrc = _rawAccessor->begin(_startAddress);
-      for(auto itdst = NDRegisterAccessor<int32_t>::buffer_2D[0].begin();
-               itdst != NDRegisterAccessor<int32_t>::buffer_2D[0].end();
-             ++itdst) {
-        *itdst = _fixedPointConverter.toCooked<int32_t>(*itsrc);
-        ++itsrc;
+      if(_saturate) {
+        _nOverflows = _fixedPointConverter.toCookedSaturating<int32_t>(reinterpret_cast<const uint32_t*>(&(*itsrc)),
+                                                                       NDRegisterAccessor<int32_t>::buffer_2D[0].data(),
+                                                                       _numberOfWords);
+      }
+      else {
+        _fixedPointConverter.toCooked<int32_t>(reinterpret_cast<const uint32_t*>(&(*itsrc)),
+                                               NDRegisterAccessor<int32_t>::buffer_2D[0].data(), _numberOfWords);
       }
     }
     else {
@@ -35,14 +38,10 @@ namespace ChimeraTK {
 
   template<>
   void NumericAddressedBackendRegisterAccessor<int32_t>::doPreWrite() {
-    if(!isRaw) {
+    if(!_rawEqualsCooked) {
       auto itdst = _rawAccessor->begin(_startAddress);
-      for(auto itsrc = NDRegisterAccessor<int32_t>::buffer_2D[0].begin();
-               itsrc != NDRegisterAccessor<int32_t>::buffer_2D[0].end();
-             ++itsrc) {
-        *itdst = _fixedPointConverter.toRaw<int32_t>(*itsrc);
-        ++itdst;
-      }
+      _fixedPointConverter.toRaw<int32_t>(NDRegisterAccessor<int32_t>::buffer_2D[0].data(),
+                                          reinterpret_cast<uint32_t*>(&(*itdst)), _numberOfWords);
     }
     else {
       if(!_rawAccessor->isShared) {
@@ -58,7 +57,7 @@ namespace ChimeraTK {
 
   template<>
   void NumericAddressedBackendRegisterAccessor<int32_t>::doPostWrite() {
-    if(isRaw) {
+    if(_rawEqualsCooked) {
       if(!_rawAccessor->isShared) {
         NDRegisterAccessor<int32_t>::buffer_2D[0].swap(_rawAccessor->rawDataBuffer);
       }
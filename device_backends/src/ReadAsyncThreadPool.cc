@@ -0,0 +1,237 @@
+/*
+ * ReadAsyncThreadPool.cc
+ */
+
+#include <algorithm>
+
+#include "ReadAsyncThreadPool.h"
+
+namespace ChimeraTK {
+
+  constexpr size_t ReadAsyncThreadPool::affinitySearchDepth;
+
+  namespace {
+    /// Flag whether the current thread is a worker of the pool
+    thread_local bool isWorkerThread = false;
+  }
+
+  /********************************************************************************************************************/
+
+  ReadAsyncThreadPool& ReadAsyncThreadPool::getInstance() {
+    // The instance is intentionally never destroyed: accessors living in static objects may still cancel their tasks
+    // during static destruction, and the workers must not run into a destroyed mutex. The workers are blocked in
+    // their wait when the process exits.
+    static ReadAsyncThreadPool *instance = new ReadAsyncThreadPool();
+    return *instance;
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::submit(Task &task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(task._state == Task::State::queued || task._state == Task::State::runningAndQueued) return;
+    if(task._state == Task::State::running) {
+      // the worker will put the task back into the queue once it has completed the current execution
+      task._state = Task::State::runningAndQueued;
+      return;
+    }
+    enqueue(task);
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::post(std::function<void()> function, const void *affinity) {
+    Task *task = new Task(std::move(function), affinity);
+    task->_ownedByPool = true;
+    std::lock_guard<std::mutex> lock(_mutex);
+    enqueue(*task);
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::enqueue(Task &task) {
+    task._state = Task::State::queued;
+    _queue.push_back(&task);
+    _taskAvailable.notify_one();
+
+    startWorkerIfNeeded();
+  }
+
+  /********************************************************************************************************************/
+
+  bool ReadAsyncThreadPool::hasSurplusWorkers() {
+    return _workers.size() - _nBlockedWorkers > _maxNumberOfThreads;
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::startWorkerIfNeeded() {
+    // start a new worker if all workers are busy
+    if(_nIdleWorkers < _queue.size() && _workers.size() - _nBlockedWorkers < _maxNumberOfThreads) {
+      _workers.emplace_back();
+      boost::thread *self = &_workers.back();
+      // The worker locks the mutex first, so the thread object is assigned before it is used by the worker.
+      _workers.back() = boost::thread([this, self] { workerLoop(self); });
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  ReadAsyncThreadPool::BlockingSection::BlockingSection()
+  : _isWorker(isWorkerThread)
+  {
+    if(!_isWorker) return;
+    ReadAsyncThreadPool &pool = getInstance();
+    std::lock_guard<std::mutex> lock(pool._mutex);
+    ++pool._nBlockedWorkers;
+    // tasks might be queued because the maximum number of threads has been reached
+    pool.startWorkerIfNeeded();
+  }
+
+  /********************************************************************************************************************/
+
+  ReadAsyncThreadPool::BlockingSection::~BlockingSection() {
+    if(!_isWorker) return;
+    ReadAsyncThreadPool &pool = getInstance();
+    std::lock_guard<std::mutex> lock(pool._mutex);
+    --pool._nBlockedWorkers;
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::cancel(Task &task) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    switch(task._state) {
+      case Task::State::idle:
+        return;
+      case Task::State::queued:
+        for(auto it = _queue.begin(); it != _queue.end(); ++it) {
+          if(*it == &task) {
+            _queue.erase(it);
+            break;
+          }
+        }
+        task._state = Task::State::idle;
+        return;
+      case Task::State::runningAndQueued:
+        task._state = Task::State::running;
+        // fall through
+      case Task::State::running:
+        task._worker->interrupt();
+        _taskFinished.wait(lock, [&task] { return task._state == Task::State::idle; });
+        return;
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::setMaxNumberOfThreads(size_t maxNumberOfThreads) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxNumberOfThreads = maxNumberOfThreads;
+    // wake up idle workers, so surplus workers can exit
+    _taskAvailable.notify_all();
+    // tasks might be queued because the old maximum number of threads had been reached
+    startWorkerIfNeeded();
+  }
+
+  /********************************************************************************************************************/
+
+  size_t ReadAsyncThreadPool::getMaxNumberOfThreads() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxNumberOfThreads;
+  }
+
+  /********************************************************************************************************************/
+
+  size_t ReadAsyncThreadPool::getNumberOfThreads() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _workers.size();
+  }
+
+  /********************************************************************************************************************/
+
+  ReadAsyncThreadPool::Task* ReadAsyncThreadPool::takeTask(const void *affinity) {
+    auto it = _queue.begin();
+    if(affinity != nullptr) {
+      size_t depth = std::min(_queue.size(), affinitySearchDepth);
+      for(auto candidate = _queue.begin(); candidate != _queue.begin() + depth; ++candidate) {
+        if((*candidate)->_affinity == affinity) {
+          it = candidate;
+          break;
+        }
+      }
+    }
+    Task *task = *it;
+    _queue.erase(it);
+    return task;
+  }
+
+  /********************************************************************************************************************/
+
+  void ReadAsyncThreadPool::workerLoop(boost::thread *self) {
+    isWorkerThread = true;
+    const void *lastAffinity = nullptr;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true) {
+      ++_nIdleWorkers;
+      _taskAvailable.wait(lock, [this] { return !_queue.empty() || hasSurplusWorkers(); });
+      --_nIdleWorkers;
+
+      // Exit if more workers than the maximum are left over, e.g. started while other workers were blocked or before
+      // the maximum has been reduced. The remaining workers can still take all queued tasks.
+      if(hasSurplusWorkers()) {
+        // the notification might have been meant for a queued task, so pass it on to another worker
+        if(!_queue.empty()) _taskAvailable.notify_one();
+        auto it = std::find_if(_workers.begin(), _workers.end(), [self](boost::thread &t) { return &t == self; });
+        it->detach();
+        _workers.erase(it);
+        return;
+      }
+
+      Task *task = takeTask(lastAffinity);
+      task->_state = Task::State::running;
+      task->_worker = self;
+      lastAffinity = task->_affinity;
+      lock.unlock();
+
+      // Execute the task. An interruption by cancel() ends the task, any other exception must be handled by the
+      // task itself.
+      try {
+        task->_function();
+      }
+      catch(boost::thread_interrupted&) {
+      }
+
+      if(task->_ownedByPool) {
+        // Nobody else refers to the task. It is deleted without holding the mutex, since destroying the function
+        // object might destroy e.g. an accessor, which then cancels its own task.
+        delete task;
+        lock.lock();
+      }
+      else {
+        lock.lock();
+        task->_worker = nullptr;
+        if(task->_state == Task::State::runningAndQueued) {
+          task->_state = Task::State::queued;
+          _queue.push_back(task);
+        }
+        else {
+          task->_state = Task::State::idle;
+          _taskFinished.notify_all();
+        }
+      }
+
+      // An interruption requested by cancel() might not have been delivered if the task completed before reaching an
+      // interruption point. Discard it here, so it does not hit the next task. cancel() cannot interrupt this thread
+      // any more, since the task is no longer in a running state.
+      try {
+        boost::this_thread::interruption_point();
+      }
+      catch(boost::thread_interrupted&) {
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -1,9 +1,11 @@
 #include "RebotBackend.h"
 #include "TcpCtrl.h"
 #include "RebotProtocolDefinitions.h"
-#include "RebotProtocol1.h"
+#include "RebotProtocol2.h"
 #include <sstream>
+#include <algorithm>
 #include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
 #include "testableRebotSleep.h"
 
 namespace ChimeraTK {
@@ -18,6 +20,9 @@ RebotBackend::RebotBackend(std::string boardAddr, int port,
       _protocolImplementor(),
       _lastSendTime(testable_rebot_sleep::now()),
       _connectionTimeout(rebot::DEFAULT_CONNECTION_TIMEOUT),
+      _pipelineDepth(rebot::DEFAULT_PIPELINE_DEPTH),
+      _nextConnection(0),
+      _minStripedReadSize(rebot::MIN_STRIPED_READ_SIZE),
       _heartbeatThread(std::bind(&RebotBackend::heartbeatLoop, this, _threadInformerMutex) ){
 }
 
@@ -31,6 +36,10 @@ RebotBackend::~RebotBackend() {
 
     if (isOpen()) {
       _tcpCommunicator->closeConnection();
+      for (auto &connection : _additionalConnections) {
+        std::lock_guard<std::mutex> connectionLock(connection->mutex);
+        connection->tcpCommunicator->closeConnection();
+      }
     }
   }// end of the lock guard scope. We have to release the lock before waiting for the thread to join
   _heartbeatThread.interrupt();
@@ -42,48 +51,212 @@ void RebotBackend::open() {
    
    std::lock_guard<std::mutex> lock(_threadInformerMutex->mutex);
    
-  _tcpCommunicator->openConnection();
-  auto serverVersion = getServerProtocolVersion();
+  _protocolImplementor = connect(_tcpCommunicator);
+
+  for (size_t i = 0; i < _additionalConnections.size(); ++i) {
+    auto &connection = *_additionalConnections[i];
+    std::lock_guard<std::mutex> connectionLock(connection.mutex);
+    try {
+      connection.protocolImplementor = connect(connection.tcpCommunicator);
+      connection.lastSendTime = testable_rebot_sleep::now();
+    }
+    catch (...) {
+      // don't leave the pool half open
+      for (size_t k = 0; k < i; ++k) {
+        std::lock_guard<std::mutex> previousLock(_additionalConnections[k]->mutex);
+        _additionalConnections[k]->tcpCommunicator->closeConnection();
+        _additionalConnections[k]->protocolImplementor.reset();
+      }
+      _tcpCommunicator->closeConnection();
+      _protocolImplementor.reset();
+      throw;
+    }
+  }
+    
+  _opened = true;
+}
+
+std::unique_ptr<RebotProtocolImplementor> RebotBackend::connect(boost::shared_ptr<TcpCtrl> &tcpCommunicator) {
+  tcpCommunicator->openConnection();
+  auto serverVersion = getServerProtocolVersion(tcpCommunicator);
   if (serverVersion == 0){
-    _protocolImplementor.reset(new RebotProtocol0(_tcpCommunicator));
+    return std::unique_ptr<RebotProtocolImplementor>(new RebotProtocol0(tcpCommunicator));
   }else if (serverVersion == 1){
-    _protocolImplementor.reset(new RebotProtocol1(_tcpCommunicator));    
+    return std::unique_ptr<RebotProtocolImplementor>(new RebotProtocol1(tcpCommunicator));
+  }else if (serverVersion == 2){
+    return std::unique_ptr<RebotProtocolImplementor>(new RebotProtocol2(tcpCommunicator));
   }else{
-    _tcpCommunicator->closeConnection();
+    tcpCommunicator->closeConnection();
     std::stringstream errorMessage;
     errorMessage << "Server protocol version " << serverVersion << " not supported!";
     throw RebotBackendException(errorMessage.str(), RebotBackendException::EX_CONNECTION_FAILED);
   }
-    
-  _opened = true;
 }
 
 void RebotBackend::read(uint8_t /*bar*/, uint32_t addressInBytes, int32_t* data,
                         size_t sizeInBytes) {
   
-  std::lock_guard<std::mutex> lock(_threadInformerMutex->mutex);                          
-                          
-  if (!isOpen()) {
-    throw RebotBackendException("Device is closed",
-                                RebotBackendException::EX_DEVICE_CLOSED);
+  if (!_additionalConnections.empty() && sizeInBytes >= _minStripedReadSize) {
+    readStriped(addressInBytes, data, sizeInBytes);
+    return;
   }
 
-  _lastSendTime=testable_rebot_sleep::now();
-  _protocolImplementor->read(addressInBytes, data, sizeInBytes);
+  transferOnAnyConnection([&](RebotProtocolImplementor &protocolImplementor) {
+    protocolImplementor.read(addressInBytes, data, sizeInBytes);
+  });
 }
 
 void RebotBackend::write(uint8_t /*bar*/, uint32_t addressInBytes, int32_t const* data,
                          size_t sizeInBytes) {
   
-  std::lock_guard<std::mutex> lock(_threadInformerMutex->mutex);
-  
+  transferOnAnyConnection([&](RebotProtocolImplementor &protocolImplementor) {
+    protocolImplementor.write(addressInBytes, data, sizeInBytes);
+  });
+}
+
+void RebotBackend::readv(const std::vector<TransferRange> &ranges) {
+
+  transferOnAnyConnection([&](RebotProtocolImplementor &protocolImplementor) {
+    protocolImplementor.readv(ranges, _pipelineDepth);
+  });
+}
+
+void RebotBackend::writev(const std::vector<TransferRange> &ranges) {
+
+  transferOnAnyConnection([&](RebotProtocolImplementor &protocolImplementor) {
+    protocolImplementor.writev(ranges, _pipelineDepth);
+  });
+}
+
+std::mutex& RebotBackend::getConnectionMutex(size_t connectionIndex) {
+  if (connectionIndex == 0) {
+    return _threadInformerMutex->mutex;
+  }
+  return _additionalConnections[connectionIndex - 1]->mutex;
+}
+
+void RebotBackend::transferOnConnection(size_t connectionIndex,
+    const std::function<void(RebotProtocolImplementor&)> &transfer) {
+
   if (!isOpen()) {
     throw RebotBackendException("Device is closed",
                                 RebotBackendException::EX_DEVICE_CLOSED);
   }
 
-  _lastSendTime=testable_rebot_sleep::now();
-  _protocolImplementor->write(addressInBytes, data, sizeInBytes);
+  if (connectionIndex == 0) {
+    _lastSendTime=testable_rebot_sleep::now();
+    transfer(*_protocolImplementor);
+  }
+  else {
+    auto &connection = *_additionalConnections[connectionIndex - 1];
+    connection.lastSendTime=testable_rebot_sleep::now();
+    transfer(*connection.protocolImplementor);
+  }
+}
+
+void RebotBackend::transferOnAnyConnection(const std::function<void(RebotProtocolImplementor&)> &transfer) {
+
+  size_t nConnections = _additionalConnections.size() + 1;
+
+  // take the first connection which is not in use
+  if (nConnections > 1) {
+    for (size_t i = 0; i < nConnections; ++i) {
+      std::unique_lock<std::mutex> lock(getConnectionMutex(i), std::try_to_lock);
+      if (lock.owns_lock()) {
+        transferOnConnection(i, transfer);
+        return;
+      }
+    }
+  }
+
+  // all connections are in use: wait for one, distributing the waiting threads over the connections
+  size_t connectionIndex = _nextConnection++ % nConnections;
+  std::lock_guard<std::mutex> lock(getConnectionMutex(connectionIndex));
+  transferOnConnection(connectionIndex, transfer);
+}
+
+void RebotBackend::readStriped(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) {
+
+  // Lock all connections, always in the order of their index to avoid deadlocks
+  size_t nConnections = _additionalConnections.size() + 1;
+  std::vector<std::unique_lock<std::mutex>> locks;
+  for (size_t i = 0; i < nConnections; ++i) {
+    locks.emplace_back(getConnectionMutex(i));
+  }
+
+  if (!isOpen()) {
+    throw RebotBackendException("Device is closed",
+                                RebotBackendException::EX_DEVICE_CLOSED);
+  }
+
+  // Send the requests for all parts first, so the server can work on them in parallel, then
+  // receive the responses. Parts are a multiple of 4 bytes, the last part takes the remainder.
+  size_t nWords = sizeInBytes / sizeof(int32_t);
+  size_t nWordsPerPart = nWords / nConnections;
+  // If sending fails on one connection, no further requests are sent.
+  std::vector<RebotProtocolImplementor*> implementors;
+  boost::exception_ptr firstException;
+  try {
+    for (size_t i = 0; i < nConnections; ++i) {
+      size_t firstWord = i * nWordsPerPart;
+      size_t partSize = (i < nConnections - 1) ? nWordsPerPart * sizeof(int32_t)
+                                               : sizeInBytes - firstWord * sizeof(int32_t);
+      transferOnConnection(i, [&](RebotProtocolImplementor &protocolImplementor) {
+        protocolImplementor.sendReadRequest(addressInBytes + firstWord * sizeof(int32_t), data + firstWord, partSize);
+        implementors.push_back(&protocolImplementor);
+      });
+    }
+  }
+  catch (...) {
+    firstException = boost::current_exception();
+  }
+
+  // Receive the responses to all requests sent, even if sending or receiving failed on another connection. Otherwise
+  // the pending responses would be taken as the responses to the next requests on these connections.
+  for (auto implementor : implementors) {
+    try {
+      implementor->receiveReadResponse();
+    }
+    catch (...) {
+      if (!firstException) firstException = boost::current_exception();
+    }
+  }
+  if (firstException) {
+    boost::rethrow_exception(firstException);
+  }
+}
+
+void RebotBackend::setPipelineDepth(size_t pipelineDepth) {
+  if (pipelineDepth == 0) {
+    throw RebotBackendException("The pipeline depth must be at least 1",
+                                RebotBackendException::EX_INVALID_PARAMETERS);
+  }
+  _pipelineDepth = pipelineDepth;
+}
+
+void RebotBackend::setMinStripedReadSize(size_t minStripedReadSize) {
+  _minStripedReadSize = minStripedReadSize;
+}
+
+void RebotBackend::setNumberOfConnections(size_t numberOfConnections) {
+  if (numberOfConnections == 0) {
+    throw RebotBackendException("The number of connections must be at least 1",
+                                RebotBackendException::EX_INVALID_PARAMETERS);
+  }
+
+  std::lock_guard<std::mutex> lock(_threadInformerMutex->mutex);
+
+  if (isOpen()) {
+    throw RebotBackendException("The number of connections can only be changed while the device is closed",
+                                RebotBackendException::EX_INVALID_PARAMETERS);
+  }
+
+  _additionalConnections.clear();
+  for (size_t i = 1; i < numberOfConnections; ++i) {
+    _additionalConnections.emplace_back(new RebotConnection);
+    _additionalConnections.back()->tcpCommunicator = boost::make_shared<TcpCtrl>(_boardAddr, _port);
+    _additionalConnections.back()->lastSendTime = testable_rebot_sleep::now();
+  }
 }
 
 void RebotBackend::close() {
@@ -93,6 +266,12 @@ void RebotBackend::close() {
   _opened = false;
   _tcpCommunicator->closeConnection();
   _protocolImplementor.reset(0);
+
+  for (auto &connection : _additionalConnections) {
+    std::lock_guard<std::mutex> connectionLock(connection->mutex);
+    connection->tcpCommunicator->closeConnection();
+    connection->protocolImplementor.reset();
+  }
 }
 
 boost::shared_ptr<DeviceBackend> RebotBackend::createInstance(
@@ -137,24 +316,26 @@ boost::shared_ptr<DeviceBackend> RebotBackend::createInstance(
       new RebotBackend(tmcbIP, portNumber, mapFileName));
 }
 
-uint32_t RebotBackend::getServerProtocolVersion() {
+uint32_t RebotBackend::getServerProtocolVersion(boost::shared_ptr<TcpCtrl> &tcpCommunicator) {
   // send a negotiation to the server:
   // sendClientProtocolVersion
-  _lastSendTime=testable_rebot_sleep::now();
+  if (tcpCommunicator == _tcpCommunicator) {
+    _lastSendTime=testable_rebot_sleep::now();
+  }
   std::vector<uint32_t> clientHelloMessage = frameClientHello();
-  _tcpCommunicator->sendData(clientHelloMessage);
+  tcpCommunicator->sendData(clientHelloMessage);
 
   // Kludge is needed to work around server bug.
   // We have a bug with the old version were only one word is returned for multiple
   // unrecognized command. Fetching one word for the 3 words send is a workaround.
-  auto serverHello = _tcpCommunicator->receiveData(1);
+  auto serverHello = tcpCommunicator->receiveData(1);
 
   if (serverHello.at(0) == rebot::UNKNOWN_INSTRUCTION) {
     return 0; // initial protocol version 0.0
   }
 
   auto remainingBytesOfAValidServerHello =
-    _tcpCommunicator->receiveData(rebot::LENGTH_OF_HELLO_TOKEN_MESSAGE - 1);
+    tcpCommunicator->receiveData(rebot::LENGTH_OF_HELLO_TOKEN_MESSAGE - 1);
 
   serverHello.insert(serverHello.end(),
                      remainingBytesOfAValidServerHello.begin(),
@@ -196,8 +377,31 @@ uint32_t RebotBackend::parseRxServerHello(
             _protocolImplementor->sendHeartbeat();
           }
         }
+        auto nextHeartbeatBase = _lastSendTime;
+        // keep the additional connections of the pool alive as well
+        if (!_additionalConnections.empty()){
+          std::lock_guard<std::mutex> lock(_threadInformerMutex->mutex);
+          if (threadInformerMutex->quitThread){
+            break;
+          }
+          for (auto &connection : _additionalConnections){
+            // a connection which is in use right now does not need a heartbeat
+            std::unique_lock<std::mutex> connectionLock(connection->mutex, std::try_to_lock);
+            if (!connectionLock.owns_lock()){
+              continue;
+            }
+            if ( (testable_rebot_sleep::now() - connection->lastSendTime) >
+                 boost::chrono::milliseconds(_connectionTimeout/2) ){
+              connection->lastSendTime=testable_rebot_sleep::now();
+              if (connection->protocolImplementor){
+                connection->protocolImplementor->sendHeartbeat();
+              }
+            }
+            nextHeartbeatBase = std::min(nextHeartbeatBase, connection->lastSendTime);
+          }
+        }
         // sleep without holding the lock. Sleep for half of the connection timeout (plus 1 ms)
-        testable_rebot_sleep::sleep_until( _lastSendTime + boost::chrono::milliseconds(_connectionTimeout/2 +1 ) );
+        testable_rebot_sleep::sleep_until( nextHeartbeatBase + boost::chrono::milliseconds(_connectionTimeout/2 +1 ) );
       }catch(RebotBackendException &e){
         std::cerr << "RebotBackend: Sending heartbeat failed. Caught exception: " << e.what() <<std::endl;
         std::cerr << "Closing connection." << std::endl;
@@ -3,6 +3,8 @@
 #include "RebotProtocolDefinitions.h"
 #include "RebotBackendException.h"
 #include <iostream>
+#include <algorithm>
+#include <array>
 
 namespace ChimeraTK{
   using namespace rebot;
@@ -56,23 +58,14 @@ namespace ChimeraTK{
   RegisterInfo registerInfo(addressInBytes, sizeInBytes);
 
   //Implementation for protocol version 0: Only single word write possible
-  const unsigned int datasendSize = 3 * sizeof(int);
+  //FIXME: Like in protocol version 1, the words are sent in host byte order, which is only correct
+  //on little endian machines.
   for (unsigned int i = 0; i < registerInfo.nWords; ++i) {
-    std::vector<char> datasend(datasendSize);
-    //FIXME: Do proper host to network conversion, no manual, platform dependent byte fiddling
-    datasend[0] = SINGLE_WORD_WRITE; // set the mode
-    for (int j = 1; j < 4; ++j) {
-      datasend[j] = 0;
-    }
-    for (int j = 4; j < 8; ++j) {
-      datasend[j] = ((registerInfo.addressInWords + i) >> (8 * (j - 4))) & 0xFF;
-    }
-    for (int j = 8; j < 12; ++j) {
-      datasend[j] = (data[i] >> (8 * (j - 8))) & 0xFF;
-    }
-    
+    std::array<uint32_t, 3> request{{static_cast<uint32_t>(SINGLE_WORD_WRITE),
+                                     registerInfo.addressInWords + i,
+                                     static_cast<uint32_t>(data[i])}};
     boost::array<char, 4> receivedData;
-    _tcpCommunicator->sendData(datasend);
+    _tcpCommunicator->sendBuffers(boost::asio::buffer(request));
     _tcpCommunicator->receiveData(receivedData);
     //FIXME: Do error handling of the response
   }
@@ -85,47 +78,161 @@ void RebotProtocol0::fetchFromRebotServer(uint32_t wordAddress,
 
   //first check that the response starts with READ_ACK. If it is an error code there might be just
   //one word in the response.
-  std::vector<int32_t> responseCode = _tcpCommunicator->receiveData(1);  
-  if (responseCode[0] != rebot::READ_ACK){
-    std::cout << "response code is " << responseCode[0] << std::endl;
+  int32_t responseCode = _tcpCommunicator->receiveWord();
+  if (responseCode != rebot::READ_ACK){
+    std::cout << "response code is " << responseCode << std::endl;
     // FIXME: can we do somwthing more clever here?
     throw RebotBackendException("Reading via ReboT failed",
                                 RebotBackendException::EX_SOCKET_READ_FAILED);
   }
 
   // now that we know that the command worked on the server side we can read the rest of the data
-  std::vector<int32_t> readData = _tcpCommunicator->receiveData(numberOfWords);
-
-  transferVectorToDataPtr(readData, dataLocation);
+  // directly into the user buffer
+  _tcpCommunicator->receiveData(dataLocation, numberOfWords);
 }
 
 void RebotProtocol0::sendRebotReadRequest(const uint32_t wordAddress, const uint32_t wordsToRead) {
 
-  unsigned int datasendSize = 3 * sizeof(int);
-  std::vector<char> datasend(datasendSize);
-  //FIXME: Do proper host to network conversion, no manual, platform dependent byte fiddling
   // send out an n word read request
-  datasend[0] = MULTI_WORD_READ;
-  for (int j = 1; j < 4; ++j) {
-    datasend[j] = 0;
+  std::array<uint32_t, 3> request{{static_cast<uint32_t>(MULTI_WORD_READ), wordAddress, wordsToRead}};
+  _tcpCommunicator->sendBuffers(boost::asio::buffer(request));
+}
+
+void RebotProtocol0::readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                           size_t pipelineDepth) {
+  _readRequests.clear();
+  for (auto &range : ranges) {
+    appendReadRequests(_readRequests, range);
   }
-  for (int j = 4; j < 8; ++j) {
-    datasend[j] = (wordAddress >> (8 * (j - 4))) & 0xFF;
+  readPipelined(_readRequests, pipelineDepth);
+}
+
+void RebotProtocol0::appendReadRequests(std::vector<ReadRequest> &requests,
+                                        const NumericAddressedBackend::TransferRange &range) {
+  RegisterInfo registerInfo(range.address, range.sizeInBytes);
+  for (uint32_t offset = 0; offset < registerInfo.nWords; offset += READ_BLOCK_SIZE) {
+    uint32_t nWords = std::min<uint32_t>(READ_BLOCK_SIZE, registerInfo.nWords - offset);
+    requests.push_back({registerInfo.addressInWords + offset, nWords, range.data + offset});
   }
-  for (int j = 8; j < 12; ++j) {
-    datasend[j] = ((wordsToRead) >> (8 * (j - 8))) & 0xFF;
+}
+
+void RebotProtocol0::readPipelined(const std::vector<ReadRequest> &requests, size_t pipelineDepth) {
+  bool readFailed = false;
+
+  transferPipelined(requests.size(), pipelineDepth,
+    [&](size_t i, SendBuffer &sendBuffer) {
+      sendBuffer.push_back(MULTI_WORD_READ);
+      sendBuffer.push_back(requests[i].wordAddress);
+      sendBuffer.push_back(requests[i].nWords);
+    },
+    [&](size_t i) {
+      if (!receiveReadData(requests[i])) {
+        readFailed = true;
+      }
+    });
+
+  if (readFailed) {
+    throw RebotBackendException("Reading via ReboT failed",
+                                RebotBackendException::EX_SOCKET_READ_FAILED);
   }
+}
 
-  _tcpCommunicator->sendData(datasend);
+bool RebotProtocol0::receiveReadData(const ReadRequest &request) {
+  // In case of an error the response consists of the error code only
+  int32_t responseCode = _tcpCommunicator->receiveWord();
+  if (responseCode != rebot::READ_ACK){
+    std::cout << "response code is " << responseCode << std::endl;
+    return false;
+  }
+  _tcpCommunicator->receiveData(request.data, request.nWords);
+  return true;
 }
 
-void RebotProtocol0::transferVectorToDataPtr(std::vector<int32_t> source, int32_t* destination) {
-  // FIXME: just use memcopy
-  for (auto& i : source) {
-    *destination = i;
-    ++destination; // this will not change the destination ptr value outside the
-                   // scope of this function (signature pass by value)
+void RebotProtocol0::sendReadRequest(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) {
+  _pendingReadRequests.clear();
+  appendReadRequests(_pendingReadRequests, {0, addressInBytes, data, sizeInBytes});
+  _sendBuffer.clear();
+  for (auto &request : _pendingReadRequests) {
+    _sendBuffer.push_back(MULTI_WORD_READ);
+    _sendBuffer.push_back(request.wordAddress);
+    _sendBuffer.push_back(request.nWords);
+  }
+  _sendBuffer.send(*_tcpCommunicator);
+}
+
+void RebotProtocol0::receiveReadResponse() {
+  // receive all responses to keep the connection usable, even if an error occurred
+  bool readFailed = false;
+  for (auto &request : _pendingReadRequests) {
+    if (!receiveReadData(request)) {
+      readFailed = true;
+    }
+  }
+  _pendingReadRequests.clear();
+  if (readFailed) {
+    throw RebotBackendException("Reading via ReboT failed",
+                                RebotBackendException::EX_SOCKET_READ_FAILED);
+  }
+}
+
+void RebotProtocol0::writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                            size_t pipelineDepth) {
+  // Protocol version 0 only knows single word writes, so there is one request per word
+  _writeRequests.clear();
+  for (auto &range : ranges) {
+    RegisterInfo registerInfo(range.address, range.sizeInBytes);
+    for (uint32_t i = 0; i < registerInfo.nWords; ++i) {
+      _writeRequests.push_back({registerInfo.addressInWords + i, range.data[i]});
+    }
+  }
+
+  transferPipelined(_writeRequests.size(), pipelineDepth,
+    [&](size_t i, SendBuffer &sendBuffer) {
+      sendBuffer.push_back(SINGLE_WORD_WRITE);
+      sendBuffer.push_back(_writeRequests[i].wordAddress);
+      sendBuffer.push_back(_writeRequests[i].value);
+    },
+    [&](size_t) {
+      boost::array<char, 4> receivedData;
+      _tcpCommunicator->receiveData(receivedData);
+      //FIXME: Do error handling of the response
+    });
+}
+
+void RebotProtocol0::transferPipelined(size_t nRequests, size_t pipelineDepth,
+    const std::function<void(size_t, SendBuffer&)> &frameRequest,
+    const std::function<void(size_t)> &receiveResponse) {
+  pipelineDepth = std::max<size_t>(pipelineDepth, 1);
+  size_t nSent = 0;
+  for (size_t nReceived = 0; nReceived < nRequests; ++nReceived) {
+    // fill up the window of requests in flight
+    _sendBuffer.clear();
+    while (nSent < nRequests && nSent - nReceived < pipelineDepth) {
+      frameRequest(nSent, _sendBuffer);
+      ++nSent;
+    }
+    if (!_sendBuffer.empty()) {
+      _sendBuffer.send(*_tcpCommunicator);
+    }
+    // the server answers the requests in the order they have been sent
+    receiveResponse(nReceived);
+  }
+}
+
+void RebotProtocol0::SendBuffer::send(TcpCtrl &tcpCommunicator) {
+  _gatherList.clear();
+  size_t wordsSent = 0;
+  for (auto &payload : _payloads) {
+    if (payload.position > wordsSent) {
+      _gatherList.push_back(boost::asio::buffer(&_words[wordsSent], (payload.position - wordsSent) * sizeof(uint32_t)));
+      wordsSent = payload.position;
+    }
+    _gatherList.push_back(boost::asio::buffer(payload.data, payload.nWords * sizeof(int32_t)));
+  }
+  if (_words.size() > wordsSent) {
+    _gatherList.push_back(boost::asio::buffer(&_words[wordsSent], (_words.size() - wordsSent) * sizeof(uint32_t)));
   }
+  tcpCommunicator.sendBuffers(_gatherList);
 }
 
 void RebotProtocol0::sendHeartbeat(){
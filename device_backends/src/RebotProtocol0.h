@@ -2,7 +2,9 @@
 #define CHIMERATK_REBOT_PROTOCOL_0
 
 #include <vector>
+#include <functional>
 #include <boost/shared_ptr.hpp>
+#include <boost/asio/buffer.hpp>
 
 #include "RebotProtocolImplementor.h"
 
@@ -16,6 +18,12 @@ namespace ChimeraTK{
     virtual void read(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) override;
     virtual void write(uint32_t addressInBytes, int32_t const* data, size_t sizeInBytes) override;
     virtual void sendHeartbeat() override;
+    virtual void readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                       size_t pipelineDepth) override;
+    virtual void writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                        size_t pipelineDepth) override;
+    virtual void sendReadRequest(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) override;
+    virtual void receiveReadResponse() override;
 
     struct RegisterInfo{
       uint32_t addressInWords;
@@ -29,7 +37,73 @@ namespace ChimeraTK{
     boost::shared_ptr<TcpCtrl> _tcpCommunicator;
     void fetchFromRebotServer(uint32_t wordAddress, uint32_t numberOfWords, int32_t* dataLocation);
     void sendRebotReadRequest(const uint32_t wordAddress, const uint32_t wordsToRead);
-    void transferVectorToDataPtr(std::vector<int32_t> source, int32_t* destination);
+
+    /// A single read request as sent to the server
+    struct ReadRequest{
+      uint32_t wordAddress;
+      uint32_t nWords;
+      int32_t* data;
+    };
+
+    /// A single word write request of protocol version 0
+    struct WriteRequest{
+      uint32_t wordAddress;
+      int32_t value;
+    };
+
+    /** Buffer for the requests sent with one write to the socket. Header words are copied into the
+     *  buffer, while payload data (e.g. the data of a write request) is only referenced and sent
+     *  directly from the user buffer. The buffer is kept between transfers, so it does not allocate
+     *  memory once it has grown to the required size. */
+    struct SendBuffer{
+      /// Append a header word
+      void push_back(uint32_t word) { _words.push_back(word); }
+      /// Append payload data. The data must stay valid until send() has been called.
+      void appendPayload(int32_t const* data, size_t nWords) {
+        _payloads.push_back({_words.size(), data, nWords});
+      }
+      bool empty() const { return _words.empty(); }
+      void clear() { _words.clear(); _payloads.clear(); }
+      /// Send everything with a single gathering write
+      void send(TcpCtrl &tcpCommunicator);
+
+      struct Payload{
+        size_t position; // number of header words to be sent before the payload
+        int32_t const* data;
+        size_t nWords;
+      };
+      std::vector<uint32_t> _words;
+      std::vector<Payload> _payloads;
+      std::vector<boost::asio::const_buffer> _gatherList;
+    };
+
+    /** Split a range into read requests the server accepts. Protocol 0 is limited to
+     *  READ_BLOCK_SIZE words per request. */
+    virtual void appendReadRequests(std::vector<ReadRequest> &requests,
+                                    const NumericAddressedBackend::TransferRange &range);
+
+    /** Send the read requests, keeping up to pipelineDepth of them in flight, and receive the
+     *  responses in order. If the server reports an error for a request, the remaining responses
+     *  are still received to keep the connection usable, and an exception is thrown at the end. */
+    void readPipelined(const std::vector<ReadRequest> &requests, size_t pipelineDepth);
+
+    /** Receive the response to a single read request into its buffer. Returns false if the server
+     *  reported an error, in which case the response consists of the error code only. */
+    bool receiveReadData(const ReadRequest &request);
+
+    /** Generic pipelining loop. frameRequest(i, buffer) appends request i to the send buffer,
+     *  receiveResponse(i) receives the response to request i. All requests which fit into the
+     *  window are sent with a single write to the socket. */
+    void transferPipelined(size_t nRequests, size_t pipelineDepth,
+                           const std::function<void(size_t, SendBuffer&)> &frameRequest,
+                           const std::function<void(size_t)> &receiveResponse);
+
+    // Buffers kept between transfers to avoid memory allocations
+    SendBuffer _sendBuffer;
+    std::vector<ReadRequest> _readRequests;
+    std::vector<WriteRequest> _writeRequests;
+    /// Requests sent by sendReadRequest(), waiting for receiveReadResponse()
+    std::vector<ReadRequest> _pendingReadRequests;
   };
 
 }// namespace ChimeraTK
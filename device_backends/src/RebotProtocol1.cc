@@ -4,6 +4,8 @@
 #include "RebotProtocolDefinitions.h"
 #include "RebotBackendException.h"
 
+#include <array>
+
 namespace ChimeraTK{
   using namespace rebot;
 
@@ -28,19 +30,57 @@ namespace ChimeraTK{
   void RebotProtocol1::write(uint32_t addressInBytes, int32_t const* data, size_t sizeInBytes) {
   
     RegisterInfo registerInfo(addressInBytes, sizeInBytes);
-    std::vector<uint32_t> writeCommandPacket;
-    writeCommandPacket.push_back(MULTI_WORD_WRITE);
-    writeCommandPacket.push_back(registerInfo.addressInWords);
-    writeCommandPacket.push_back(registerInfo.nWords);
-    for (unsigned int i = 0; i < registerInfo.nWords; ++i) {
-      writeCommandPacket.push_back(data[i]);
-    }
+    // The header is followed by the data, which is sent directly from the user buffer
+    std::array<uint32_t, 3> header{{static_cast<uint32_t>(MULTI_WORD_WRITE),
+                                    registerInfo.addressInWords, registerInfo.nWords}};
+    std::array<boost::asio::const_buffer, 2> writeCommandPacket{{
+        boost::asio::buffer(header), boost::asio::buffer(data, registerInfo.nWords * sizeof(int32_t))}};
     // Again we timestamp here. Technically the comminucator might send muptilple packets,
     // but it is sufficient to reemember that we triggered it here.
     _lastSendTime = std::chrono::steady_clock::now();    
-    _tcpCommunicator->sendData(writeCommandPacket);
-    // FIXME: this returns std::vector<int32_t> of length 1. Do error handling!
-    (void) _tcpCommunicator->receiveData(1);
+    _tcpCommunicator->sendBuffers(writeCommandPacket);
+    // FIXME: Do error handling!
+    (void) _tcpCommunicator->receiveWord();
+  }
+
+  void RebotProtocol1::readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                             size_t pipelineDepth) {
+    // One time stamp for all requests is sufficient, see read()
+    _lastSendTime = std::chrono::steady_clock::now();
+    RebotProtocol0::readv(ranges, pipelineDepth);
+  }
+
+  void RebotProtocol1::sendReadRequest(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) {
+    _lastSendTime = std::chrono::steady_clock::now();
+    RebotProtocol0::sendReadRequest(addressInBytes, data, sizeInBytes);
+  }
+
+  void RebotProtocol1::appendReadRequests(std::vector<ReadRequest> &requests,
+                                          const NumericAddressedBackend::TransferRange &range) {
+    RegisterInfo registerInfo(range.address, range.sizeInBytes);
+    requests.push_back({registerInfo.addressInWords, registerInfo.nWords, range.data});
+  }
+
+  void RebotProtocol1::writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                              size_t pipelineDepth) {
+    // check all ranges before the first request is sent
+    for (auto &range : ranges) {
+      RegisterInfo(range.address, range.sizeInBytes);
+    }
+
+    _lastSendTime = std::chrono::steady_clock::now();
+    transferPipelined(ranges.size(), pipelineDepth,
+      [&](size_t i, SendBuffer &sendBuffer) {
+        RegisterInfo registerInfo(ranges[i].address, ranges[i].sizeInBytes);
+        sendBuffer.push_back(MULTI_WORD_WRITE);
+        sendBuffer.push_back(registerInfo.addressInWords);
+        sendBuffer.push_back(registerInfo.nWords);
+        sendBuffer.appendPayload(ranges[i].data, registerInfo.nWords);
+      },
+      [&](size_t) {
+        // FIXME: Do error handling!
+        (void) _tcpCommunicator->receiveWord();
+      });
   }
 
   void RebotProtocol1::sendHeartbeat(){
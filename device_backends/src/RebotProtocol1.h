@@ -13,6 +13,16 @@ namespace ChimeraTK{
     virtual void read(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) override;
     virtual void write(uint32_t addressInBytes, int32_t const* data, size_t sizeInBytes) override;
     virtual void sendHeartbeat() override;
+    virtual void readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                       size_t pipelineDepth) override;
+    virtual void writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                        size_t pipelineDepth) override;
+
+    virtual void sendReadRequest(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes) override;
+
+    /// Protocol 1 reads each range with a single request
+    virtual void appendReadRequests(std::vector<ReadRequest> &requests,
+                                    const NumericAddressedBackend::TransferRange &range) override;
 
     /** No need to make it atomic (time_points cannot be because they are not trivially copyable).
      * It is protected by the hardware accessing mutex in the
@@ -0,0 +1,115 @@
+#include "RebotProtocol2.h"
+
+#include "TcpCtrl.h"
+#include "RebotProtocolDefinitions.h"
+#include "RebotBackendException.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace ChimeraTK{
+  using namespace rebot;
+
+  RebotProtocol2::RebotProtocol2(boost::shared_ptr<TcpCtrl> & tcpCommunicator)
+    : RebotProtocol1(tcpCommunicator){
+  }
+
+  void RebotProtocol2::prepareRequests(const std::vector<NumericAddressedBackend::TransferRange> &ranges) {
+    auto &segments = _segments;
+    auto &requests = _multiRangeRequests;
+    segments.clear();
+    requests.clear();
+
+    // split ranges which are too large for a single request
+    for (auto &range : ranges) {
+      RegisterInfo registerInfo(range.address, range.sizeInBytes);
+      for (uint32_t offset = 0; offset < registerInfo.nWords; offset += MULTI_RANGE_MAX_WORDS) {
+        uint32_t nWords = std::min(MULTI_RANGE_MAX_WORDS, registerInfo.nWords - offset);
+        segments.push_back({registerInfo.addressInWords + offset, nWords, range.data + offset});
+      }
+    }
+
+    // put as many segments as possible into each request
+    size_t nWordsInRequest = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+      if (requests.empty() || requests.back().end - requests.back().begin == MULTI_RANGE_MAX_RANGES ||
+          nWordsInRequest + segments[i].nWords > MULTI_RANGE_MAX_WORDS) {
+        requests.push_back({i, i});
+        nWordsInRequest = 0;
+      }
+      ++requests.back().end;
+      nWordsInRequest += segments[i].nWords;
+    }
+  }
+
+  void RebotProtocol2::readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                             size_t pipelineDepth) {
+    prepareRequests(ranges);
+    auto &segments = _segments;
+    auto &requests = _multiRangeRequests;
+
+    _lastSendTime = std::chrono::steady_clock::now();
+    bool readFailed = false;
+    transferPipelined(requests.size(), pipelineDepth,
+      [&](size_t i, SendBuffer &sendBuffer) {
+        sendBuffer.push_back(MULTI_RANGE_READ);
+        sendBuffer.push_back(requests[i].end - requests[i].begin);
+        for (size_t k = requests[i].begin; k < requests[i].end; ++k) {
+          sendBuffer.push_back(segments[k].wordAddress);
+          sendBuffer.push_back(segments[k].nWords);
+        }
+      },
+      [&](size_t i) {
+        // In case of an error the response consists of the error code only
+        int32_t responseCode = _tcpCommunicator->receiveWord();
+        if (responseCode != READ_ACK){
+          std::cout << "response code is " << responseCode << std::endl;
+          readFailed = true;
+          return;
+        }
+        for (size_t k = requests[i].begin; k < requests[i].end; ++k) {
+          _tcpCommunicator->receiveData(segments[k].data, segments[k].nWords);
+        }
+      });
+
+    if (readFailed) {
+      throw RebotBackendException("Reading via ReboT failed",
+                                  RebotBackendException::EX_SOCKET_READ_FAILED);
+    }
+  }
+
+  void RebotProtocol2::writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                              size_t pipelineDepth) {
+    prepareRequests(ranges);
+    auto &segments = _segments;
+    auto &requests = _multiRangeRequests;
+
+    _lastSendTime = std::chrono::steady_clock::now();
+    bool writeFailed = false;
+    transferPipelined(requests.size(), pipelineDepth,
+      [&](size_t i, SendBuffer &sendBuffer) {
+        sendBuffer.push_back(MULTI_RANGE_WRITE);
+        sendBuffer.push_back(requests[i].end - requests[i].begin);
+        for (size_t k = requests[i].begin; k < requests[i].end; ++k) {
+          sendBuffer.push_back(segments[k].wordAddress);
+          sendBuffer.push_back(segments[k].nWords);
+        }
+        for (size_t k = requests[i].begin; k < requests[i].end; ++k) {
+          sendBuffer.appendPayload(segments[k].data, segments[k].nWords);
+        }
+      },
+      [&](size_t) {
+        int32_t responseCode = _tcpCommunicator->receiveWord();
+        if (responseCode != WRITE_ACK){
+          std::cout << "response code is " << responseCode << std::endl;
+          writeFailed = true;
+        }
+      });
+
+    if (writeFailed) {
+      throw RebotBackendException("Writing via ReboT failed",
+                                  RebotBackendException::EX_SOCKET_WRITE_FAILED);
+    }
+  }
+
+} // namespace ChimeraTK
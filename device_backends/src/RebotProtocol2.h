@@ -0,0 +1,44 @@
+#ifndef CHIMERATK_REBOT_PROTOCOL_2
+#define CHIMERATK_REBOT_PROTOCOL_2
+
+#include "RebotProtocol1.h"
+
+namespace ChimeraTK{
+
+  /** Protocol version 2 transfers a list of address ranges with a single request and response
+   *  (MULTI_RANGE_READ and MULTI_RANGE_WRITE). Single transfers are done as in version 1.
+   */
+  struct RebotProtocol2 : public RebotProtocol1{
+    explicit RebotProtocol2(boost::shared_ptr<TcpCtrl> & tcpCommunicator);
+    virtual ~RebotProtocol2(){};
+
+    virtual void readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                       size_t pipelineDepth) override;
+    virtual void writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                        size_t pipelineDepth) override;
+
+    /// A part of a transfer range which fits into one request
+    struct Segment{
+      uint32_t wordAddress;
+      uint32_t nWords;
+      int32_t* data;
+    };
+
+    /// A request consists of the segments [begin, end)
+    struct MultiRangeRequest{
+      size_t begin;
+      size_t end;
+    };
+
+    /** Split the ranges into _segments and group them into _multiRangeRequests, respecting the
+     *  limits MULTI_RANGE_MAX_RANGES and MULTI_RANGE_MAX_WORDS. */
+    void prepareRequests(const std::vector<NumericAddressedBackend::TransferRange> &ranges);
+
+    // Kept between transfers to avoid memory allocations
+    std::vector<Segment> _segments;
+    std::vector<MultiRangeRequest> _multiRangeRequests;
+  };
+
+}// namespace ChimeraTK
+
+#endif // CHIMERATK_REBOT_PROTOCOL_2
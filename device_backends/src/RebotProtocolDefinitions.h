@@ -2,6 +2,7 @@
 #define CHIMERAT_REBOT_PROTOCOL_DEFINITIONS
 
 #include <cstdint>
+#include <cstddef>
 
 namespace ChimeraTK{
 
@@ -18,10 +19,19 @@ namespace rebot{
   static const int32_t MULTI_WORD_READ = 3;
   static const int32_t PING = 5;
   static const int32_t SET_SESSION_TIMEOUT = 6;
+  // Protocol version 2: scatter/gather lists of address ranges in a single request.
+  // Read request: MULTI_RANGE_READ, nRanges, {addressInWords, nWords} x nRanges
+  //   response: READ_ACK followed by the data of all ranges, or an error code
+  // Write request: MULTI_RANGE_WRITE, nRanges, {addressInWords, nWords} x nRanges, data of all ranges
+  //   response: WRITE_ACK or an error code
+  static const int32_t MULTI_RANGE_READ = 7;
+  static const int32_t MULTI_RANGE_WRITE = 8;
+  static const uint32_t MULTI_RANGE_MAX_RANGES = 1024; // per request
+  static const uint32_t MULTI_RANGE_MAX_WORDS = 0x100000; // data words per request (4 MB)
 
   // Most Significant 16 bits ==  major version
   // Least Significant 16 bits == minor version
-  static const int32_t CLIENT_PROTOCOL_VERSION = 0x00000001;
+  static const int32_t CLIENT_PROTOCOL_VERSION = 0x00000002;
 
   static const int32_t READ_ACK = 1000;
   static const int32_t WRITE_ACK = 1001;
@@ -31,6 +41,8 @@ namespace rebot{
   
   static const unsigned int DEFAULT_SERVER_PORT = 5001;
   static const int32_t DEFAULT_CONNECTION_TIMEOUT = 10000; // 10 seconds
+  static const size_t DEFAULT_PIPELINE_DEPTH = 16; // requests in flight in readv()/writev()
+  static const size_t MIN_STRIPED_READ_SIZE = 0x10000; // bytes, with more than one connection
 
 }//namespace rebot
 
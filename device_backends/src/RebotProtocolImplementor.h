@@ -3,6 +3,9 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <vector>
+
+#include "NumericAddressedBackend.h"
 
 namespace ChimeraTK{
   
@@ -16,7 +19,41 @@ namespace ChimeraTK{
     virtual void write(uint32_t addressInBytes, int32_t const* data,
                        size_t sizeInBytes) = 0;
     virtual void sendHeartbeat() = 0;
+
+    /** Read several address ranges. Implementations can send up to pipelineDepth requests before
+     *  reading the first response, so the round trip time is not paid for each request. The
+     *  default implementation reads the ranges one after another. */
+    virtual void readv(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                       size_t /*pipelineDepth*/){
+      for (auto &range : ranges){
+        read(range.address, range.data, range.sizeInBytes);
+      }
+    }
+
+    /** Send the request(s) to read a contiguous range without waiting for the response, which
+     *  must be received with receiveReadResponse() before the connection is used otherwise.
+     *  This allows large reads to be striped over several connections. The default
+     *  implementation does the entire read in receiveReadResponse(). */
+    virtual void sendReadRequest(uint32_t addressInBytes, int32_t* data, size_t sizeInBytes){
+      _deferredRead = {0, addressInBytes, data, sizeInBytes};
+    }
+
+    /** Receive the data requested by sendReadRequest() into the buffer given there. */
+    virtual void receiveReadResponse(){
+      read(_deferredRead.address, _deferredRead.data, _deferredRead.sizeInBytes);
+    }
+
+    /** Write several address ranges, see readv(). */
+    virtual void writev(const std::vector<NumericAddressedBackend::TransferRange> &ranges,
+                        size_t /*pipelineDepth*/){
+      for (auto &range : ranges){
+        write(range.address, range.data, range.sizeInBytes);
+      }
+    }
     virtual ~RebotProtocolImplementor(){};
+
+  protected:
+    NumericAddressedBackend::TransferRange _deferredRead{0, 0, nullptr, 0};
   };
   
 }// namespace ChimeraTK
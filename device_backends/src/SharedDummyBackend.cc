@@ -1,42 +1,90 @@
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <sstream>
 #include <functional>
+#include <thread>
+#include <type_traits>
+#include <signal.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #include <boost/lambda/lambda.hpp>
+#include <boost/thread.hpp>
 
 #include "SharedDummyBackend.h"
+#include "AtomicWordCopy.h"
 #include "NotImplementedException.h"
 #include "MapFileParser.h"
 #include "parserUtilities.h"
 #include "BackendFactory.h"
 
-//macro to avoid code duplication
-#define TRY_REGISTER_ACCESS(COMMAND)\
-    try{\
-      COMMAND\
-    }catch( std::out_of_range & outOfRangeException ){\
-      std::stringstream errorMessage;\
-      errorMessage << "Invalid address offset " << address \
-      << " in bar " << static_cast<int>(bar) << "."	\
-      << "Caught out_of_range exception: " << outOfRangeException.what();\
-      throw DeviceException(errorMessage.str(), DeviceException::WRONG_PARAMETER);\
+// The sequence counters are accessed by several processes, which only works if they are lock-free
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "std::atomic<uint32_t> must be lock-free to be used in shared memory");
+static_assert(sizeof(pid_t) == sizeof(int), "std::atomic<pid_t> must be lock-free to be used in shared memory");
+
+namespace ChimeraTK {
+
+  namespace {
+
+#ifdef __linux__
+    // The futex words are in the shared memory and used by several processes, so the non-private futex operations
+    // are required.
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "std::atomic<uint32_t> cannot be used as futex");
+
+    /// Sleep until the word has been changed and woken up with wakeAllWaiting(), but at most for the timeout
+    void waitForChange(std::atomic<uint32_t> &word, uint32_t expectedValue, const struct timespec &timeout) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expectedValue, &timeout, nullptr, 0);
     }
 
+    void wakeAllWaiting(std::atomic<uint32_t> &word) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    // Without futexes, waiting threads check the word in the interval given as timeout.
+    void waitForChange(std::atomic<uint32_t> &, uint32_t, const struct timespec &timeout) {
+      nanosleep(&timeout, nullptr);
+    }
+
+    void wakeAllWaiting(std::atomic<uint32_t> &) {}
+#endif
+
+    // Waiting threads wake up in this interval to check whether they have been interrupted or the backend has been
+    // closed. Notifications by writers wake them up immediately on Linux, elsewhere this is the polling interval.
+    const struct timespec WAIT_FOR_WRITE_CHECK_INTERVAL = {0, 10000000};
+
+    // Readers and writers which cannot access a bar check after this number of retries whether the owner of the bar
+    // has died. They give up if the bar cannot be accessed within the timeout.
+    const size_t BUSY_BAR_CHECK_INTERVAL = 1000;
+    const std::chrono::seconds BUSY_BAR_TIMEOUT(1);
+
+    // Both segment types are accessed through the same segment manager
+    static_assert(std::is_same<boost::interprocess::managed_shared_memory::segment_manager,
+                               boost::interprocess::managed_mapped_file::segment_manager>::value,
+                  "Shared memory and mapped file segments must have the same segment manager");
+
+  }
 
-namespace ChimeraTK {
   // Valid bar numbers are 0 to 5 , so they must be contained
   // in three bits.
   const unsigned int BAR_MASK = 0x7;
   // the bar number is stored in bits 60 to 62
   const unsigned int BAR_POSITION_IN_VIRTUAL_REGISTER = 60;
 
-  SharedDummyBackend::SharedDummyBackend(std::string instanceId, std::string mapFileName)
+  SharedDummyBackend::SharedDummyBackend(std::string instanceId, std::string mapFileName,
+      std::string segmentDirectory)
   : NumericAddressedBackend(mapFileName),
     _mapFile(mapFileName),
     //TODO Nasty to use base class member as argument here?
     _registerMapping(_registerMap),
     _barSizesInBytes(getBarSizesInBytesFromRegisterMapping()),
-    sharedMemoryManager(*this, instanceId, mapFileName)
+    sharedMemoryManager(*this, instanceId, mapFileName, segmentDirectory)
   {
     // Note: Opposed to the other dummies, _registerMap is computed in the base class ctor
     //       because we rely on a fixed init-order for the boost::interprocess members
@@ -50,40 +98,17 @@ namespace ChimeraTK {
   SharedDummyBackend::~SharedDummyBackend(){
   }
 
-  // Construct a segment for each bar and set required size
+  // Construct the contents of each bar in the shared memory
   void SharedDummyBackend::setupBarContents(){
 
-    for (std::map< uint8_t, size_t >::const_iterator barSizeInBytesIter
-           = _barSizesInBytes.begin();
-         barSizeInBytesIter != _barSizesInBytes.end();
-         ++barSizeInBytesIter){
-
-      std::string barName = "Bar"+std::to_string(barSizeInBytesIter->first);
-
-      size_t barSizeInWords = (barSizeInBytesIter->second + sizeof(int32_t) - 1)/sizeof(int32_t);
-
-      try{
-        _barContents[barSizeInBytesIter->first] = sharedMemoryManager.findOrConstructVector(barName, barSizeInWords);
+    sharedMemoryManager.setupBars(_bars);
 
 #ifdef _DEBUG
-        std::cout << "Constructed bar: " << barName << std::endl
-                  << "    with a size of " << barSizeInBytesIter->second << std::endl
-                  << "    Memory size: " << sharedMemoryManager.getInfoOnMemory().first << std::endl
-                  << "    Free memory is: " << sharedMemoryManager.getInfoOnMemory().second
-                  << std::endl << std::flush;
+    std::cout << "Constructed " << _barSizesInBytes.size() << " bars" << std::endl
+              << "    Memory size: " << sharedMemoryManager.getInfoOnMemory().first << std::endl
+              << "    Free memory is: " << sharedMemoryManager.getInfoOnMemory().second
+              << std::endl << std::flush;
 #endif
-      }
-      catch(boost::interprocess::bad_alloc &e){\
-        // TODO Decide if we trigger grow() on the shd mem from here,
-        // but this requires that the shd mem is unmapped in all processes.
-        std::cout << "Caught " << e.what() << " while constructing/resizing " + barName << std::endl
-                  << "    Shared memory size: " << sharedMemoryManager.getInfoOnMemory().first << std::endl
-                  << "    Memory required: " << getTotalRegisterSizeInBytes()
-                  << std::endl << std::flush;
-
-        sharedMemoryManager.~SharedMemoryManager();
-      }
-    } /* for(barSizesInBytesIter) */
   }
 
   std::map< uint8_t, size_t > SharedDummyBackend::getBarSizesInBytesFromRegisterMapping() const{
@@ -118,9 +143,22 @@ namespace ChimeraTK {
       throw DeviceException("Device is closed.", DeviceException::NOT_OPENED);
     }
     checkSizeIsMultipleOfWordSize( sizeInBytes );
-    unsigned int wordBaseIndex = address/sizeof(int32_t);
-    for (unsigned int wordIndex = 0; wordIndex < sizeInBytes/sizeof(int32_t); ++wordIndex){
-      TRY_REGISTER_ACCESS( data[wordIndex] = _barContents[bar]->at(wordBaseIndex+wordIndex); );
+    SharedBar &sharedBar = getBar(bar, address, sizeInBytes);
+    const int32_t *source = sharedBar.data + address/sizeof(int32_t);
+
+    // Copy the data and retry if a write has modified the bar in the meantime (seqlock, see SharedBar)
+    auto firstAttempt = std::chrono::steady_clock::now();
+    for(size_t nRetries = 1; ; ++nRetries) {
+      uint32_t sequenceBefore = sharedBar.sequence->load(std::memory_order_acquire);
+      if(sequenceBefore & 1) {
+        std::this_thread::yield();
+      }
+      else {
+        atomicWordCopy(data, source, sizeInBytes/sizeof(int32_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(sharedBar.sequence->load(std::memory_order_relaxed) == sequenceBefore) return;
+      }
+      if(nRetries % BUSY_BAR_CHECK_INTERVAL == 0) handleBusyBar(sharedBar, firstAttempt);
     }
   }
 
@@ -129,12 +167,117 @@ namespace ChimeraTK {
       throw DeviceException("Device is closed.", DeviceException::NOT_OPENED);
     }
     checkSizeIsMultipleOfWordSize( sizeInBytes );
-    unsigned int wordBaseIndex = address/sizeof(int32_t);
-    for (unsigned int wordIndex = 0; wordIndex < sizeInBytes/sizeof(int32_t); ++wordIndex){
-      TRY_REGISTER_ACCESS( _barContents[bar]->at(wordBaseIndex+wordIndex) = data[wordIndex]; );
+    SharedBar &sharedBar = getBar(bar, address, sizeInBytes);
+
+    lockBar(sharedBar);
+    // Make the sequence counter odd. It is already odd if the previous owner has died during a write.
+    uint32_t sequence = sharedBar.sequence->load(std::memory_order_relaxed) | 1;
+    sharedBar.sequence->store(sequence, std::memory_order_relaxed);
+    // the data must not be modified before the odd sequence counter is visible
+    std::atomic_thread_fence(std::memory_order_release);
+
+    atomicWordCopy(sharedBar.data + address/sizeof(int32_t), data, sizeInBytes/sizeof(int32_t));
+
+    // publish the written range while still owning the bar, so the ring buffer entries are not written concurrently
+    WriteNotification &notification = *sharedBar.notification;
+    uint32_t writeCount = notification.writeCount.load(std::memory_order_relaxed);
+    uint64_t firstWord = address/sizeof(int32_t);
+    notification.ranges[writeCount % WriteNotification::nRanges].store(
+        (firstWord << 32) | (firstWord + sizeInBytes/sizeof(int32_t)), std::memory_order_release);
+    notification.writeCount.store(writeCount + 1);
+
+    sharedBar.sequence->store(sequence + 1, std::memory_order_release);
+    sharedBar.owner->store(0, std::memory_order_release);
+
+    if(notification.nWaiters.load() > 0) wakeAllWaiting(notification.writeCount);
+  }
+
+  void SharedDummyBackend::lockBar(SharedBar &bar){
+    pid_t self = getpid();
+    auto firstAttempt = std::chrono::steady_clock::now();
+    for(size_t nRetries = 1; ; ++nRetries) {
+      pid_t owner = 0;
+      if(bar.owner->compare_exchange_weak(owner, self, std::memory_order_acquire)) return;
+      if(owner != 0) std::this_thread::yield();
+      if(nRetries % BUSY_BAR_CHECK_INTERVAL == 0) handleBusyBar(bar, firstAttempt);
+    }
+  }
+
+  void SharedDummyBackend::handleBusyBar(SharedBar &bar, std::chrono::steady_clock::time_point firstAttempt){
+    // Only a process which does not exist any more is a dead owner. Processes of other users cannot be signalled
+    // (EPERM), but they are alive.
+    pid_t owner = bar.owner->load(std::memory_order_acquire);
+    if(owner != 0 && kill(owner, 0) != 0 && errno == ESRCH) {
+      // Take over the bar, so only one process completes the aborted write
+      if(bar.owner->compare_exchange_strong(owner, getpid(), std::memory_order_acquire)) {
+        uint32_t sequence = bar.sequence->load(std::memory_order_relaxed);
+        if(sequence & 1) bar.sequence->store(sequence + 1, std::memory_order_release);
+        bar.owner->store(0, std::memory_order_release);
+      }
+      return;
+    }
+    if(std::chrono::steady_clock::now() - firstAttempt > BUSY_BAR_TIMEOUT) {
+      std::stringstream errorMessage;
+      errorMessage << "Timeout accessing the shared memory: the bar is locked by process " << owner << ".";
+      throw DeviceException(errorMessage.str(), DeviceException::CANNOT_OPEN_DEVICEBACKEND);
     }
   }
 
+  uint32_t SharedDummyBackend::getWriteCount(uint8_t bar){
+    return getBar(bar, 0, 0).notification->writeCount.load(std::memory_order_acquire);
+  }
+
+  bool SharedDummyBackend::waitForWrite(uint8_t bar, uint32_t address, size_t sizeInBytes, uint32_t &writeCount,
+      bool blocking){
+    if (!_opened){
+      throw DeviceException("Device is closed.", DeviceException::NOT_OPENED);
+    }
+    WriteNotification &notification = *getBar(bar, address, sizeInBytes).notification;
+    uint64_t firstWord = address/sizeof(int32_t);
+    uint64_t endWord = firstWord + sizeInBytes/sizeof(int32_t);
+
+    while(true) {
+      uint32_t currentCount = notification.writeCount.load(std::memory_order_acquire);
+
+      // check the ranges of all writes since the last call, unless they have been overwritten in the ring buffer
+      bool written = (currentCount - writeCount > WriteNotification::nRanges);
+      for(uint32_t count = writeCount; !written && count != currentCount; ++count) {
+        uint64_t range = notification.ranges[count % WriteNotification::nRanges].load(std::memory_order_acquire);
+        written = ((range >> 32) < endWord && (range & 0xFFFFFFFF) > firstWord);
+      }
+      // entries might have been overwritten by writes during the check
+      if(notification.writeCount.load(std::memory_order_relaxed) - writeCount >= WriteNotification::nRanges) {
+        written = true;
+      }
+      writeCount = currentCount;
+      if(written || !blocking) return written;
+
+      // sleep until the next write. Announce the waiter first, so the writer issues the wake-up call.
+      ++notification.nWaiters;
+      waitForChange(notification.writeCount, currentCount, WAIT_FOR_WRITE_CHECK_INTERVAL);
+      --notification.nWaiters;
+
+      // allow the ReadAsyncThreadPool to cancel the wait
+      boost::this_thread::interruption_point();
+      if (!_opened){
+        throw DeviceException("Device is closed.", DeviceException::NOT_OPENED);
+      }
+    }
+  }
+
+  SharedDummyBackend::SharedBar& SharedDummyBackend::getBar(uint8_t bar, uint32_t address, size_t sizeInBytes){
+    SharedBar &sharedBar = _bars[bar];
+    // the address is truncated to full words
+    size_t wordBaseIndex = address/sizeof(int32_t);
+    if (sharedBar.data == nullptr || wordBaseIndex + sizeInBytes/sizeof(int32_t) > sharedBar.sizeInWords){
+      std::stringstream errorMessage;
+      errorMessage << "Invalid address offset " << address << " in bar " << static_cast<int>(bar)
+                   << " for an access of " << sizeInBytes << " bytes.";
+      throw DeviceException(errorMessage.str(), DeviceException::WRONG_PARAMETER);
+    }
+    return sharedBar;
+  }
+
   std::string SharedDummyBackend::readDeviceInfo(){
     std::stringstream info;
     info << "SharedDummyBackend with mapping file " << _registerMapping->getMapFileName();
@@ -169,11 +312,18 @@ namespace ChimeraTK {
       throw ChimeraTK::DeviceException("No map file name given.", ChimeraTK::DeviceException::WRONG_PARAMETER);
     }
 
+    // the optional second parameter is the directory of the segment file, e.g. a hugetlbfs mount
+    std::string segmentDirectory;
+    if(parameters.size() > 1) {
+      segmentDirectory = *(++parameters.begin());
+    }
+
     // when the factory is used to create the dummy device, mapfile path in the
     // dmap file is relative to the dmap file location. Converting the relative
     // mapFile path to an absolute path avoids issues when the dmap file is not
     // in the working directory of the application.
-    return returnInstance<SharedDummyBackend>(instance, instance, convertPathRelativeToDmapToAbs(mapFileName));
+    return returnInstance<SharedDummyBackend>(instance, instance, convertPathRelativeToDmapToAbs(mapFileName),
+                                              segmentDirectory);
   }
 
   std::string SharedDummyBackend::convertPathRelativeToDmapToAbs(const std::string& mapfileName) {
@@ -187,12 +337,154 @@ namespace ChimeraTK {
 
   // Member functions of nested shared memory class
 
-  SharedMemoryVector* SharedDummyBackend::SharedMemoryManager::findOrConstructVector(const std::string& objName, const size_t size){
+  SharedDummyBackend::SharedMemoryManager::SharedMemoryManager(SharedDummyBackend &sharedDummyBackend_,
+      const std::string instanceId, const std::string mapFileName, const std::string segmentDirectory_) :
+    sharedDummyBackend(sharedDummyBackend_),
+    segmentDirectory(segmentDirectory_),
+    pageSize(getPageSize(segmentDirectory_)),
+    mapFileHash(std::to_string(std::hash<std::string>{}(mapFileName))),
+    instanceIdHash(std::to_string(std::hash<std::string>{}(instanceId))),
+    name("ChimeraTK_SharedDummy_"+mapFileHash+"_"+instanceIdHash),
+    globalMutex(boost::interprocess::open_or_create, name.c_str())
+  {
+    // lock guard with the interprocess mutex
+    std::lock_guard<boost::interprocess::named_mutex> lock(globalMutex);
+
+    mapSegment();
+
+    // increment use counter
+    (*useCount)++;
+
+#ifdef _DEBUG
+    std::cout << "Created shared memory with a size of " << segmentManager->get_size() << " bytes." << std::endl;
+    std::cout << "    Free space : " << segmentManager->get_free_memory() << std::endl;
+    std::cout << "    useCount is: " << *useCount << std::endl << std::flush;
+#endif
+  }
+
+  SharedDummyBackend::SharedMemoryManager::~SharedMemoryManager() {
 
-    SharedMemoryVector* vector = segment.find_or_construct<SharedMemoryVector>(objName.c_str())(alloc_inst);
+    // lock guard with the interprocess mutex
+    std::lock_guard<boost::interprocess::named_mutex> lock(globalMutex);
+
+    // decrement use counter
+    (*useCount)--;
+
+    // if use count at 0, destroy shared memory and the interprocess mutex
+    if(*useCount == 0) {
+      if(segmentDirectory.empty()) {
+        boost::interprocess::shared_memory_object::remove(name.c_str());
+      }
+      else {
+        boost::interprocess::file_mapping::remove(getSegmentFileName().c_str());
+      }
+      boost::interprocess::named_mutex::remove(name.c_str());
+    }
+  }
+
+  void SharedDummyBackend::SharedMemoryManager::setupBars(std::array<SharedBar, 256> &bars){
+
+    std::lock_guard<boost::interprocess::named_mutex> lock(globalMutex);
+
+    while(true) {
+      // another process might have grown the segment since it has been mapped here
+      if(segmentManager->get_size() != mappedSize) {
+        mapSegment();
+      }
+
+      try{
+        // already constructed bars are just found again after growing the segment
+        for(auto &barSizeInBytes : sharedDummyBackend._barSizesInBytes) {
+          std::string barName = "Bar"+std::to_string(barSizeInBytes.first);
+          size_t barSizeInWords = (barSizeInBytes.second + sizeof(int32_t) - 1)/sizeof(int32_t);
+          bars[barSizeInBytes.first] = findOrConstructBar(barName, barSizeInWords);
+        }
+        return;
+      }
+      catch(boost::interprocess::bad_alloc &){
+        // Grow by at least the full requirement (and double the segment for repeated growing), so this terminates.
+        growSegment(roundUpToPageSize(std::max(getRequiredMemoryWithOverhead(), mappedSize)));
+      }
+    }
+  }
+
+  SharedDummyBackend::SharedBar SharedDummyBackend::SharedMemoryManager::findOrConstructBar(
+      const std::string& barName, const size_t sizeInWords){
+
+    // find_or_construct is atomic, so concurrently starting processes agree on the objects
+    SharedBar bar;
+    bar.data = segmentManager->find_or_construct<int32_t>((barName + "_data").c_str())[sizeInWords](0);
+    bar.sequence = segmentManager->find_or_construct<std::atomic<uint32_t>>((barName + "_sequence").c_str())(0);
+    bar.owner = segmentManager->find_or_construct<std::atomic<pid_t>>((barName + "_owner").c_str())(0);
+    // value-initialisation zeroes the counters and the ring buffer
+    bar.notification = segmentManager->find_or_construct<WriteNotification>((barName + "_notification").c_str())();
+    bar.sizeInWords = sizeInWords;
+
+    // an existing bar might have been created by a process with a different size
+    if(segmentManager->find<int32_t>((barName + "_data").c_str()).second < sizeInWords) {
+      throw DeviceException("The shared memory contains the bar " + barName + " with a smaller size.",
+                            DeviceException::WRONG_PARAMETER);
+    }
+    return bar;
+  }
+
+  void SharedDummyBackend::SharedMemoryManager::mapSegment(){
+    // If the segment exists, it is mapped in its current size. The previous mapping is released by the assignment, so
+    // all pointers into the segment have to be obtained again.
+    if(segmentDirectory.empty()) {
+      sharedMemorySegment = boost::interprocess::managed_shared_memory(boost::interprocess::open_or_create,
+          name.c_str(), getRequiredMemoryWithOverhead());
+      segmentManager = sharedMemorySegment.get_segment_manager();
+    }
+    else {
+      fileSegment = boost::interprocess::managed_mapped_file(boost::interprocess::open_or_create,
+          getSegmentFileName().c_str(), getRequiredMemoryWithOverhead());
+      segmentManager = fileSegment.get_segment_manager();
+    }
+    mappedSize = segmentManager->get_size();
+
+    // pointers into the previous mapping are invalid
+    useCount = segmentManager->find_or_construct<size_t>("UseCounter")(0);
+  }
+
+  void SharedDummyBackend::SharedMemoryManager::growSegment(size_t extraBytes){
+    // Enlarging the file does not affect existing mappings, so other processes can continue to use their bars.
+    bool success;
+    if(segmentDirectory.empty()) {
+      success = boost::interprocess::managed_shared_memory::grow(name.c_str(), extraBytes);
+    }
+    else {
+      success = boost::interprocess::managed_mapped_file::grow(getSegmentFileName().c_str(), extraBytes);
+    }
+    if(!success) {
+      std::stringstream errorMessage;
+      errorMessage << "Cannot grow the shared memory " << name << " of " << mappedSize << " bytes by " << extraBytes
+                   << " bytes.";
+      throw DeviceException(errorMessage.str(), DeviceException::CANNOT_OPEN_DEVICEBACKEND);
+    }
+    mapSegment();
+  }
+
+  size_t SharedDummyBackend::SharedMemoryManager::getPageSize(const std::string &segmentDirectory){
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    if(!segmentDirectory.empty()) {
+      // the block size reported for a hugetlbfs mount is its huge page size
+      struct statvfs fileSystemInfo;
+      if(statvfs(segmentDirectory.c_str(), &fileSystemInfo) != 0) {
+        throw DeviceException("Cannot access the shared memory directory '" + segmentDirectory + "': " +
+                              strerror(errno), DeviceException::WRONG_PARAMETER);
+      }
+      pageSize = std::max(pageSize, static_cast<size_t>(fileSystemInfo.f_bsize));
+    }
+    return pageSize;
+  }
+
+  std::string SharedDummyBackend::SharedMemoryManager::getSegmentFileName() const{
+    return segmentDirectory + "/" + name;
+  }
 
-    vector->resize(size, 0);
-    return vector;
+  size_t SharedDummyBackend::SharedMemoryManager::roundUpToPageSize(size_t size) const{
+    return (size + pageSize - 1)/pageSize*pageSize;
   }
 
   size_t SharedDummyBackend::SharedMemoryManager::getRequiredMemoryWithOverhead(){
@@ -200,13 +492,13 @@ namespace ChimeraTK {
 
     // Note: This uses _barSizeInBytes to determine number of vectors used,
     //       as it is initialized when this method gets called in the init list.
-    return SHARED_MEMORY_OVERHEAD_PER_VECTOR * sharedDummyBackend._barSizesInBytes.size()  \
-           + SHARED_MEMORY_CONST_OVERHEAD                                                  \
-           + sharedDummyBackend.getTotalRegisterSizeInBytes();
+    return roundUpToPageSize(SHARED_MEMORY_OVERHEAD_PER_BAR * sharedDummyBackend._barSizesInBytes.size()  \
+                             + SHARED_MEMORY_CONST_OVERHEAD                                                  \
+                             + sharedDummyBackend.getTotalRegisterSizeInBytes());
   }
 
   std::pair<size_t, size_t> SharedDummyBackend::SharedMemoryManager::getInfoOnMemory(){
-    return std::make_pair(segment.get_size(), segment.get_free_memory());
+    return std::make_pair(segmentManager->get_size(), segmentManager->get_free_memory());
   }
 
 } // namespace mtca4u
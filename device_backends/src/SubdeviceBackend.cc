@@ -117,8 +117,9 @@ namespace ChimeraTK {
     public:
 
       FixedPointConvertingDecorator(const boost::shared_ptr<ChimeraTK::NDRegisterAccessor<TargetUserType>> &target,
-                                    FixedPointConverter fixedPointConverter)
-      : NDRegisterAccessorDecorator<UserType, TargetUserType>(target), _fixedPointConverter(fixedPointConverter)
+                                    FixedPointConverter fixedPointConverter, bool saturate)
+      : NDRegisterAccessorDecorator<UserType, TargetUserType>(target), _fixedPointConverter(fixedPointConverter),
+        _saturate(saturate), _nOverflows(0)
       {}
 
       void doPreRead() override {
@@ -127,18 +128,24 @@ namespace ChimeraTK {
 
       void doPostRead() override {
         _target->postRead();
+        _nOverflows = 0;
         for(size_t i = 0; i < this->buffer_2D.size(); ++i) {
-          for(size_t j = 0; j < this->buffer_2D[i].size(); ++j) {
-            buffer_2D[i][j] = _fixedPointConverter.toCooked<UserType>(_target->accessChannel(i)[j]);
+          auto rawValues = reinterpret_cast<const uint32_t*>(_target->accessChannel(i).data());
+          if(_saturate) {
+            _nOverflows += _fixedPointConverter.toCookedSaturating<UserType>(rawValues, buffer_2D[i].data(),
+                                                                             buffer_2D[i].size());
+          }
+          else {
+            _fixedPointConverter.toCooked<UserType>(rawValues, buffer_2D[i].data(), buffer_2D[i].size());
           }
         }
       }
 
       void doPreWrite() override {
         for(size_t i = 0; i < this->buffer_2D.size(); ++i) {
-          for(size_t j = 0; j < this->buffer_2D[i].size(); ++j) {
-            _target->accessChannel(i)[j] = _fixedPointConverter.toRaw<UserType>(buffer_2D[i][j]);
-          }
+          _fixedPointConverter.toRaw<UserType>(buffer_2D[i].data(),
+                                               reinterpret_cast<uint32_t*>(_target->accessChannel(i).data()),
+                                               buffer_2D[i].size());
         }
         _target->preWrite();
       }
@@ -151,13 +158,22 @@ namespace ChimeraTK {
         auto casted = boost::dynamic_pointer_cast<FixedPointConvertingDecorator<UserType,TargetUserType> const>(other);
         if(!casted) return false;
         if(_fixedPointConverter != casted->_fixedPointConverter) return false;
+        if(_saturate != casted->_saturate) return false;
         return _target->mayReplaceOther(casted->_target);
       }
 
+      size_t getNumberOfOverflows() const override {
+        return _nOverflows;
+      }
+
     protected:
 
       FixedPointConverter _fixedPointConverter;
 
+      /** flag whether AccessMode::saturate is set, and the number of saturated values in the last read transfer */
+      bool _saturate;
+      size_t _nOverflows;
+
       using NDRegisterAccessorDecorator<UserType, TargetUserType>::_target;
       using NDRegisterAccessor<UserType>::buffer_2D;
 
@@ -212,7 +228,8 @@ namespace ChimeraTK {
     /// @todo keep other flags!!!
     auto rawAcc = targetDevice->getRegisterAccessor<int32_t>(targetArea, numberOfWords, wordOffset, {AccessMode::raw});
     return boost::make_shared<FixedPointConvertingDecorator<UserType, int32_t>>(rawAcc,
-                  FixedPointConverter(registerPathName, info->width, info->nFractionalBits, info->signedFlag) );
+                  FixedPointConverter(registerPathName, info->width, info->nFractionalBits, info->signedFlag),
+                  flags.has(AccessMode::saturate) );
   }
 
 
@@ -33,6 +33,10 @@ namespace ChimeraTK{
         throw RebotBackendException("Could not connect to server",
                                     RebotBackendException::EX_CONNECTION_FAILED);
       }
+
+      // Requests are small and pipelined requests are sent before the previous response has
+      // arrived, so don't let Nagle's algorithm hold them back.
+      _socket->set_option(boost_ip::tcp::no_delay(true));
     }
     catch (std::exception &exception) {
       throw RebotBackendException(exception.what(),
@@ -63,6 +67,22 @@ namespace ChimeraTK{
     }
   }
   
+  void TcpCtrl::receiveData(int32_t* data, size_t numWordsToRead) {
+    try {
+      boost::asio::read(*_socket, boost::asio::buffer(data, numWordsToRead * sizeof(int32_t)));
+    }
+    catch (...) {
+      throw RebotBackendException("Error reading from socket",
+                                  RebotBackendException::EX_SOCKET_READ_FAILED);
+    }
+  }
+
+  int32_t TcpCtrl::receiveWord() {
+    int32_t word;
+    receiveData(&word, 1);
+    return word;
+  }
+
   void TcpCtrl::sendData(const std::vector<char> &data) {
     try {
       boost::asio::write(*_socket, boost::asio::buffer(&data[0], data.size()));
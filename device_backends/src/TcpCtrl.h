@@ -35,9 +35,16 @@ class TcpCtrl {
     ///Receives int32_t words from the socket.
     std::vector<int32_t> receiveData(uint32_t const &numWordsToRead);
     void receiveData(boost::array<char, 4>& receivedArray);
+    ///Receives int32_t words from the socket directly into the given buffer.
+    void receiveData(int32_t* data, size_t numWordsToRead);
+    ///Receives a single int32_t word from the socket.
+    int32_t receiveWord();
     ///Sends a std::vector of bytes to the socket.
     void sendData(const std::vector<char> &data);
     void sendData(const std::vector<uint32_t> &data);
+    ///Sends a sequence of buffers (e.g. a header and the user data) with a single gathering write.
+    template<typename ConstBufferSequence>
+    void sendBuffers(const ConstBufferSequence &buffers);
     ///Returns an IP address associated with an object of the class.
     std::string getAddress();
     ///Sets an IP address in an object. Can be done when connection is closed.
@@ -61,6 +68,17 @@ class TcpCtrl {
         boost::asio::ip::tcp::resolver::iterator endpointIterator);
 };
 
+template<typename ConstBufferSequence>
+void TcpCtrl::sendBuffers(const ConstBufferSequence &buffers) {
+  try {
+    boost::asio::write(*_socket, buffers);
+  }
+  catch (...) {
+    throw RebotBackendException("Error writing to socket",
+                                RebotBackendException::EX_SOCKET_WRITE_FAILED);
+  }
+}
+
 }//namespace ChimeraTK
 
 #endif /* CHIMERATK_TCPCTRL_H */
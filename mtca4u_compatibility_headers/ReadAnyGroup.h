@@ -0,0 +1,8 @@
+#pragma once
+#include <ChimeraTK/ReadAnyGroup.h>
+
+//#warning You are using the deprecated namespace 'mtca4u'. Please change to namespace 'ChimeraTK'.
+
+namespace mtca4u{
+  using namespace ChimeraTK;
+}
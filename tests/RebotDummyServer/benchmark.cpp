@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "RebotDummyServer.h"
+#include "RebotBackend.h"
+#include "argumentParser.h"
+
+using namespace ChimeraTK;
+
+/**
+ *
+ * Usage: ( cd tests ; ../bin/RebotBenchmark [<NumberOfIterations>] [-l <latency in us>] [-b <bandwidth in bytes/s>] )
+ *
+ * Measures the round trip time and the throughput of the RebotBackend against the RebotDummyServer on the loopback
+ * interface, for all protocol versions. The server runs in the same process. The latency and bandwidth arguments
+ * are passed to the server to emulate a real network. <NumberOfIterations> defaults to 1000.
+ *
+ * The results are also written to rebot_benchmark.txt, one <name>=<value> per line.
+ *
+*/
+
+static const unsigned int FIRST_SERVER_PORT = 5101;
+static const uint32_t TEST_AREA_ADDRESS = 0x30;
+static const size_t TEST_AREA_SIZE_IN_WORDS = 1024;
+
+/**************************************************************************/
+
+template<typename FUNCTION>
+double measureMicroseconds(int nIterations, FUNCTION function) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < nIterations; ++i) {
+    function();
+  }
+  auto duration = std::chrono::steady_clock::now() - t0;
+  return std::chrono::duration<double, std::micro>(duration).count() / nIterations;
+}
+
+/**************************************************************************/
+
+void runBenchmark(unsigned int protocolVersion, unsigned int port, int nIterations, std::ofstream &fresult) {
+  std::string prefix = "V" + std::to_string(protocolVersion) + "_";
+  std::vector<int32_t> block(TEST_AREA_SIZE_IN_WORDS);
+  double blockSizeInMB = 4. * TEST_AREA_SIZE_IN_WORDS / 1e6;
+
+  RebotBackend backend("127.0.0.1", port);
+  backend.open();
+
+  int32_t word = 0;
+  double t = measureMicroseconds(nIterations, [&] { backend.read(0, 0x04, &word, sizeof(word)); });
+  std::cout << "  single word read:  " << t << " us" << std::endl;
+  fresult << prefix << "SINGLE_READus=" << std::round(t) << std::endl;
+
+  t = measureMicroseconds(nIterations, [&] { backend.write(0, TEST_AREA_ADDRESS, &word, sizeof(word)); });
+  std::cout << "  single word write: " << t << " us" << std::endl;
+  fresult << prefix << "SINGLE_WRITEus=" << std::round(t) << std::endl;
+
+  t = measureMicroseconds(nIterations, [&] { backend.read(0, TEST_AREA_ADDRESS, block.data(), 4*block.size()); });
+  std::cout << "  block read:        " << t << " us (" << blockSizeInMB / t * 1e6 << " MB/s)" << std::endl;
+  fresult << prefix << "BLOCK_READus=" << std::round(t) << std::endl;
+
+  t = measureMicroseconds(nIterations, [&] { backend.write(0, TEST_AREA_ADDRESS, block.data(), 4*block.size()); });
+  std::cout << "  block write:       " << t << " us (" << blockSizeInMB / t * 1e6 << " MB/s)" << std::endl;
+  fresult << prefix << "BLOCK_WRITEus=" << std::round(t) << std::endl;
+
+  // many small ranges, like a TransferGroup with scalar accessors
+  std::vector<NumericAddressedBackend::TransferRange> ranges;
+  for (uint32_t i = 0; i < 50; ++i) {
+    ranges.push_back({0, TEST_AREA_ADDRESS + 8*i, block.data() + i, 4});
+  }
+  for (size_t pipelineDepth : {1, 16}) {
+    backend.setPipelineDepth(pipelineDepth);
+    t = measureMicroseconds(nIterations, [&] { backend.readv(ranges); });
+    std::cout << "  readv of 50 words, pipeline depth " << pipelineDepth << ": " << t << " us" << std::endl;
+    fresult << prefix << "READV_DEPTH" << pipelineDepth << "us=" << std::round(t) << std::endl;
+  }
+  backend.close();
+
+  // concurrent single word reads from several threads, with and without connection pool
+  const size_t nThreads = 4;
+  for (size_t nConnections : {size_t(1), nThreads}) {
+    RebotBackend pooledBackend("127.0.0.1", port);
+    pooledBackend.setNumberOfConnections(nConnections);
+    pooledBackend.open();
+    std::vector<std::thread> threads;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nThreads; ++i) {
+      threads.emplace_back([&] {
+        int32_t threadWord;
+        for (int k = 0; k < nIterations; ++k) {
+          pooledBackend.read(0, 0x04, &threadWord, sizeof(threadWord));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto duration = std::chrono::steady_clock::now() - t0;
+    t = std::chrono::duration<double, std::micro>(duration).count() / (nIterations * nThreads);
+    std::cout << "  " << nThreads << " threads, " << nConnections << " connection(s): " << t
+              << " us per single word read" << std::endl;
+    fresult << prefix << "THREADS" << nThreads << "_CONNECTIONS" << nConnections << "us=" << std::round(t)
+            << std::endl;
+  }
+}
+
+/**************************************************************************/
+
+int main(int argc, char **argv) {
+  int nIterations = 1000;
+  if (argc > 1 && argv[1][0] != '-') {
+    nIterations = atoi(argv[1]);
+  }
+  auto latency = std::chrono::microseconds(getLatency(argv));
+  uint64_t bandwidthLimit = getBandwidthLimit(argv);
+
+  std::ofstream fresult("rebot_benchmark.txt", std::ofstream::out);
+
+  for (unsigned int protocolVersion = 0; protocolVersion <= 2; ++protocolVersion) {
+    unsigned int port = FIRST_SERVER_PORT + protocolVersion;
+    RebotDummyServer server(port, "./mtcadummy_rebot.map", protocolVersion);
+    server.setLatency(latency);
+    server.setBandwidthLimit(bandwidthLimit);
+    std::thread serverThread([&server] { server.start(); });
+
+    std::cout << " ***************************************************************************" << std::endl;
+    std::cout << " Protocol version " << protocolVersion << ":" << std::endl;
+    runBenchmark(protocolVersion, port, nIterations, fresult);
+    server.printStatistics(std::cout);
+
+    server.stop();
+    serverThread.join();
+  }
+
+  return 0;
+}
@@ -5,11 +5,11 @@
 
 namespace ChimeraTK{
   
-class RebotDummyServer;
+class RebotDummySession;
 
 /// Only put commands which don't exist in all versions, or behave differently
 struct DummyProtocol1: public DummyProtocol0{
-  DummyProtocol1(RebotDummyServer & parent);
+  DummyProtocol1(RebotDummySession & parent);
     
   /// The multi word read is not limited in the size any more
   virtual void multiWordRead(std::vector<uint32_t>& buffer);
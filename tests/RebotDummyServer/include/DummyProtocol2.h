@@ -0,0 +1,26 @@
+#ifndef DUMMY_PROTOCOL_2_H
+#define DUMMY_PROTOCOL_2_H
+
+#include "DummyProtocol1.h"
+
+namespace ChimeraTK{
+  
+class RebotDummySession;
+
+/// Only put commands which don't exist in all versions, or behave differently
+struct DummyProtocol2: public DummyProtocol1{
+  DummyProtocol2(RebotDummySession & parent);
+
+  /// First protocol version that implements the scatter/gather transfers
+  virtual void multiRangeRead(std::vector<uint32_t>& buffer) override;
+  virtual void multiRangeWrite(std::vector<uint32_t>& buffer) override;
+
+  virtual uint32_t protocolVersion() override {return 2;}
+
+  /// Check the limits of the list of ranges, and send an error code if they are exceeded
+  bool checkRangeList(std::vector<uint32_t>& buffer);
+};
+
+}//  namespace ChimeraTK
+
+#endif //DUMMY_PROTOCOL_2_H
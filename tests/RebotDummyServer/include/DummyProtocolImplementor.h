@@ -13,6 +13,10 @@ struct DummyProtocolImplementor{
   virtual uint32_t multiWordWrite(std::vector<uint32_t>& buffer)=0;
   virtual uint32_t continueMultiWordWrite(std::vector<uint32_t>& buffer)=0;
 
+  // scatter/gather transfers of a list of address ranges
+  virtual void multiRangeRead(std::vector<uint32_t>& buffer)=0;
+  virtual void multiRangeWrite(std::vector<uint32_t>& buffer)=0;
+
   virtual void hello(std::vector<uint32_t>& buffer)=0;
   virtual void ping(std::vector<uint32_t>& buffer)=0;
   /// implement this for EVERY protocol version
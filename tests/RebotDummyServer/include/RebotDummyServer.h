@@ -6,6 +6,12 @@
 #include <boost/asio.hpp>
 #include "DummyProtocolImplementor.h"
 #include <atomic>
+#include <array>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <thread>
 
 namespace ip = boost::asio::ip;
 
@@ -17,9 +23,15 @@ namespace ChimeraTK {
   
 extern bool volatile stop_rebot_server;
 
+class RebotDummySession;
+
 /*
  * starts a blocking Rebot server on localhost:port. where port is the
  * portNumber specified during object creation.
+ *
+ * Each client connection is handled in its own thread (see RebotDummySession), so several clients
+ * can be served concurrently. For performance measurements an artificial network latency and a
+ * bandwidth limit can be configured, and the server counts the received commands.
  */
 class RebotDummyServer {
 
@@ -32,9 +44,17 @@ class RebotDummyServer {
   void stop();
   virtual ~RebotDummyServer();
 
+  // Delay each response by the given time after the request has been received. Requests which
+  // arrive together (e.g. pipelined requests) are delayed in parallel, like on a network.
+  void setLatency(std::chrono::microseconds latency);
+  // Limit the data rate of the responses of each connection. 0 means unlimited.
+  void setBandwidthLimit(uint64_t bytesPerSecond);
+  // Print the number of connections, transferred bytes and received commands
+  void printStatistics(std::ostream &stream);
+
   // The following stuff is only intended for the protocol implementors and the server itself
 
-  static const int BUFFER_SIZE_IN_WORDS = 256;
+  static const int BUFFER_SIZE_IN_WORDS = 16384;
   static const int32_t READ_SUCCESS_INDICATION = 1000;
   static const int32_t WRITE_SUCCESS_INDICATION = 1001;
   static const uint32_t PONG = 1005;
@@ -46,6 +66,10 @@ class RebotDummyServer {
   static const uint32_t MULTI_WORD_READ = 3;
   static const uint32_t HELLO = 4;
   static const uint32_t PING = 5;
+  static const uint32_t MULTI_RANGE_READ = 7;
+  static const uint32_t MULTI_RANGE_WRITE = 8;
+  static const uint32_t MULTI_RANGE_MAX_RANGES = 1024;
+  static const uint32_t MULTI_RANGE_MAX_WORDS = 0x100000;
   static const uint32_t REBOT_MAGIC_WORD = 0x72626f74; // ascii code 'rbot'
   
   // internal states. Currently there are only two when the connection is open
@@ -53,9 +77,6 @@ class RebotDummyServer {
   // a multi word write can be so large that it needs more than one package
   static const uint32_t INSIDE_MULTI_WORD_WRITE = 2;
 
-  // The actual state: ready for new command or not
-  uint32_t _state;
-
   std::atomic<uint32_t> _heartbeatCount;
   std::atomic<uint32_t> _helloCount; // in protocol version 1 we have to send hello instead of heartbeat
   std::atomic<bool> _dont_answer; // flag to cause an error condition
@@ -66,15 +87,59 @@ class RebotDummyServer {
   boost::asio::io_service _io;
   ip::tcp::endpoint _serverEndpoint;
   ip::tcp::acceptor _connectionAcceptor;
+
+  std::chrono::microseconds _latency;
+  uint64_t _bandwidthLimit;
+
+  // statistics. Commands with a code >= N_COUNTED_COMMANDS are counted in the last entry.
+  static const uint32_t N_COUNTED_COMMANDS = 10;
+  std::array<std::atomic<uint64_t>, N_COUNTED_COMMANDS> _commandCount;
+  std::atomic<uint64_t> _connectionCount;
+  std::atomic<uint64_t> _bytesReceived;
+  std::atomic<uint64_t> _bytesSent;
+
+  // the active client connections and their threads
+  std::mutex _sessionsMutex;
+  std::list<std::pair<boost::shared_ptr<RebotDummySession>, std::thread>> _sessions;
+  // join the threads of sessions which have ended
+  void removeFinishedSessions();
+};
+
+/*
+ * A client connection of the RebotDummyServer. Processes the requests of the client until the
+ * connection is closed. Each session has its own protocol implementor, since the protocol state
+ * (e.g. of a multi word write) belongs to the connection.
+ */
+class RebotDummySession {
+
+  // everything is public so all protocol implementors can reach it
+ public:
+  RebotDummySession(RebotDummyServer &server, boost::shared_ptr<ip::tcp::socket> socket);
+
+  // handle the requests until the client closes the connection or the server is stopped
+  void run();
+  // can be called from another thread to end run()
+  void shutdown();
+
+  RebotDummyServer &_server;
+  DummyBackend &_registerSpace;
   boost::shared_ptr<ip::tcp::socket> _currentClientConnection;
   std::unique_ptr<DummyProtocolImplementor> _protocolImplementor;
-  
+  std::atomic<bool> _finished;
+
+  // The actual state: ready for new command or not
+  uint32_t _state;
+
   void processReceivedPackage(std::vector<uint32_t> &buffer);
+  // Returns the length of the request at the beginning of the buffer in words, or 0 if the buffer does not
+  // contain enough data yet to determine it.
+  size_t getRequestLength(const uint32_t *words, size_t nWordsAvailable);
   void writeWordToRequestedAddress(std::vector<uint32_t> &buffer);
   void readRegisterAndSendData(std::vector<uint32_t> &buffer);
-  void handleAcceptedConnection(boost::shared_ptr<ip::tcp::socket>& );
   // most commands have a singe work as response. Avoid code duplication.
   void sendSingleWord(int32_t response);
+  // all responses are sent through this function, which applies the bandwidth limit
+  void sendData(boost::asio::const_buffer data);
 };
 
 } /* namespace ChimeraTK */
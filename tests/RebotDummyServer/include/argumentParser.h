@@ -5,5 +5,8 @@
 unsigned int getPortNumber(char **);
 std::string getMapFileLocation(char **);
 unsigned int getProtocolVersion(char **);
+unsigned int getLatency(char **);
+unsigned long getBandwidthLimit(char **);
+unsigned int getStatisticsInterval(char **);
 
 #endif /* SOURCE_DIRECTORY__TESTS_REBOTDUMMYSERVER_ARGUMENTPARSER_H_ */
@@ -1,5 +1,5 @@
-
 #include <iostream>
+#include <thread>
 #include <signal.h>
 
 #include "RebotDummyServer.h"
@@ -23,9 +23,38 @@ int main(int, char** argv) {
   unsigned int portNumber = getPortNumber(argv);
   std::string mapFileLocation = getMapFileLocation(argv);
   unsigned int protocolVersion = getProtocolVersion(argv);
+  unsigned int statisticsInterval = getStatisticsInterval(argv);
   
   ChimeraTK::RebotDummyServer testServer(portNumber, mapFileLocation, protocolVersion);
+  testServer.setLatency(std::chrono::microseconds(getLatency(argv)));
+  testServer.setBandwidthLimit(getBandwidthLimit(argv));
+
+  // print the statistics periodically if requested
+  std::thread statisticsThread;
+  if (statisticsInterval > 0) {
+    statisticsThread = std::thread([&testServer, statisticsInterval] {
+      // the terminate signal has to go to the main thread
+      sigset_t signalSet;
+      sigemptyset(&signalSet);
+      sigaddset(&signalSet, SIGTERM);
+      pthread_sigmask(SIG_BLOCK, &signalSet, nullptr);
+      auto nextPrint = std::chrono::steady_clock::now() + std::chrono::seconds(statisticsInterval);
+      while (!ChimeraTK::stop_rebot_server) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() >= nextPrint) {
+          testServer.printStatistics(std::cout);
+          nextPrint += std::chrono::seconds(statisticsInterval);
+        }
+      }
+    });
+  }
+
   testServer.start();
 
+  if (statisticsThread.joinable()) {
+    statisticsThread.join();
+    testServer.printStatistics(std::cout);
+  }
+
   return 0;
 }
@@ -3,7 +3,7 @@
 
 namespace ChimeraTK{
   
-  DummyProtocol0::DummyProtocol0(RebotDummyServer & parent)
+  DummyProtocol0::DummyProtocol0(RebotDummySession & parent)
     : _parent(parent) {
   }
 
@@ -35,6 +35,14 @@ namespace ChimeraTK{
     return RebotDummyServer::ACCEPT_NEW_COMMAND;
   }
 
+  void DummyProtocol0::multiRangeRead(std::vector<uint32_t>& /*buffer*/){
+    _parent.sendSingleWord(RebotDummyServer::UNKNOWN_INSTRUCTION);
+  }
+
+  void DummyProtocol0::multiRangeWrite(std::vector<uint32_t>& /*buffer*/){
+    _parent.sendSingleWord(RebotDummyServer::UNKNOWN_INSTRUCTION);
+  }
+
   void DummyProtocol0::hello(std::vector<uint32_t>& /*buffer*/){
     _parent.sendSingleWord(RebotDummyServer::UNKNOWN_INSTRUCTION);
   }
@@ -1,10 +1,11 @@
 #include "DummyProtocol1.h"
 #include "RebotDummyServer.h"
 #include <boost/asio.hpp>
+#include <algorithm>
 
 namespace ChimeraTK{
 
-  DummyProtocol1::DummyProtocol1(RebotDummyServer & parent) :
+  DummyProtocol1::DummyProtocol1(RebotDummySession & parent) :
     DummyProtocol0(parent),
     _nextAddressInWords(0),
     _nWordsLeft(0){
@@ -14,13 +15,15 @@ namespace ChimeraTK{
     _parent.readRegisterAndSendData(buffer);
   }
 
-  void DummyProtocol1::hello(std::vector<uint32_t>& /*buffer*/){
+  void DummyProtocol1::hello(std::vector<uint32_t>& buffer){
     // currently there is no check that the buffer is correct
-    // from protocol 2 magic work will be checked, and maybe client version
+    // Answer with the highest version supported by both sides. Clients of protocol version 1 would
+    // reject a higher server version. Versions are only compatible upwards from 1.
+    uint32_t clientVersion = buffer.at(2);
     std::vector<uint32_t> outputBuffer={RebotDummyServer::HELLO,
                                       RebotDummyServer::REBOT_MAGIC_WORD,
-                                      protocolVersion()};
-    boost::asio::write(*(_parent._currentClientConnection), boost::asio::buffer(outputBuffer));
+                                      std::max(std::min(protocolVersion(), clientVersion), 1U)};
+    _parent.sendData(boost::asio::buffer(outputBuffer));
   }
 
   uint32_t DummyProtocol1::multiWordWrite(std::vector<uint32_t>& buffer){
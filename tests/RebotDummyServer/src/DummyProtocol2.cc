@@ -0,0 +1,61 @@
+#include "DummyProtocol2.h"
+#include "RebotDummyServer.h"
+#include <boost/asio.hpp>
+
+namespace ChimeraTK{
+
+  DummyProtocol2::DummyProtocol2(RebotDummySession & parent) :
+    DummyProtocol1(parent){
+  }
+
+  bool DummyProtocol2::checkRangeList(std::vector<uint32_t>& buffer){
+    uint32_t nRanges = buffer.at(1);
+    uint64_t nWordsTotal = 0;
+    for (uint32_t i = 0; i < nRanges; ++i) {
+      nWordsTotal += buffer.at(3 + 2*i);
+    }
+    if (nRanges > RebotDummyServer::MULTI_RANGE_MAX_RANGES ||
+        nWordsTotal > RebotDummyServer::MULTI_RANGE_MAX_WORDS) {
+      _parent.sendSingleWord(RebotDummyServer::TOO_MUCH_DATA_REQUESTED);
+      return false;
+    }
+    return true;
+  }
+
+  void DummyProtocol2::multiRangeRead(std::vector<uint32_t>& buffer){
+    if (!checkRangeList(buffer)) {
+      return;
+    }
+
+    // collect the data of all ranges and send it with the acknowledge in one go
+    uint32_t nRanges = buffer.at(1);
+    std::vector<int32_t> dataToSend(1, RebotDummyServer::READ_SUCCESS_INDICATION);
+    for (uint32_t i = 0; i < nRanges; ++i) {
+      uint32_t addressInWords = buffer.at(2 + 2*i);
+      uint32_t nWords = buffer.at(3 + 2*i);
+      size_t offset = dataToSend.size();
+      dataToSend.resize(offset + nWords);
+      _parent._registerSpace.read(BAR, addressInWords * 4, dataToSend.data() + offset, 4*nWords);
+    }
+    _parent.sendData(boost::asio::buffer(dataToSend));
+  }
+
+  void DummyProtocol2::multiRangeWrite(std::vector<uint32_t>& buffer){
+    if (!checkRangeList(buffer)) {
+      return;
+    }
+
+    // the data of all ranges follows the list of ranges
+    uint32_t nRanges = buffer.at(1);
+    size_t dataOffset = 2 + 2*nRanges;
+    for (uint32_t i = 0; i < nRanges; ++i) {
+      uint32_t addressInWords = buffer.at(2 + 2*i);
+      uint32_t nWords = buffer.at(3 + 2*i);
+      _parent._registerSpace.write(BAR, addressInWords * 4,
+                                   reinterpret_cast<int32_t *>(buffer.data() + dataOffset), 4*nWords);
+      dataOffset += nWords;
+    }
+    _parent.sendSingleWord(RebotDummyServer::WRITE_SUCCESS_INDICATION);
+  }
+
+}//namespace ChimeraTK
@@ -1,10 +1,14 @@
 
 #include "RebotDummyServer.h"
-#include "DummyProtocol1.h" // the latest version includes all predecessors in the include
+#include "DummyProtocol2.h" // the latest version includes all predecessors in the include
 #include <iostream>
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 #include <stdexcept>
+#include <cstring>
+#include <signal.h>
+#include <sys/socket.h>
  
 namespace ChimeraTK {
 
@@ -12,8 +16,7 @@ bool volatile stop_rebot_server = false;
 
   RebotDummyServer::RebotDummyServer(unsigned int portNumber, std::string mapFile,
                                      unsigned int protocolVersion)
-    :  _state(ACCEPT_NEW_COMMAND),
-       _heartbeatCount(0),
+    :  _heartbeatCount(0),
        _helloCount(0),
        _dont_answer(false),
        _registerSpace(mapFile),
@@ -22,20 +25,21 @@ bool volatile stop_rebot_server = false;
       _io(),
       _serverEndpoint(ip::tcp::v4(), _serverPort),
       _connectionAcceptor(_io, _serverEndpoint),
-      _currentClientConnection() {
+      _latency(0),
+      _bandwidthLimit(0),
+      _connectionCount(0),
+      _bytesReceived(0),
+      _bytesSent(0) {
 
-    if (protocolVersion == 0){
-      _protocolImplementor.reset(new DummyProtocol0(*this));
-    }else if (protocolVersion == 1){
-      _protocolImplementor.reset(new DummyProtocol1(*this));
-    }else{
+    if (protocolVersion > 2){
       throw std::invalid_argument("RebotDummyServer: unknown protocol version");
     }
+    for (auto &count : _commandCount){
+      count = 0;
+    }
       
-  // set the acceptor backlog to 1
-  /*  _connectionAcceptor.open(_serverEndpoint.protocol());
-    _connectionAcceptor.bind(_serverEndpoint);*/
-  _connectionAcceptor.listen(1);
+  // several clients can connect at the same time
+  _connectionAcceptor.listen();
 
   // The first address of the register space is set to a reference value. This
   // would be used to test the rebot client.
@@ -51,7 +55,7 @@ void RebotDummyServer::start() {
   stop_rebot_server = false; // might have been stopped before
   
   while (stop_rebot_server ==
-         false) { // loop accepts client connections - one at a time
+         false) { // loop accepts client connections
 
     boost::shared_ptr<ip::tcp::socket> incomingConnection(
         new ip::tcp::socket(_io));
@@ -66,52 +70,148 @@ void RebotDummyServer::start() {
       }
     }
 
-    // http://www.boost.org/doc/libs/1_46_0/doc/html/boost_asio/example/echo/blocking_tcp_echo_server.cpp
-    RebotDummyServer::handleAcceptedConnection(incomingConnection);
-    // boost::asio::detail::thread
-    // t(boost::bind(&RebotDummyServer::handleAcceptedConnection, this,
-    // incomingConnection));
+    ++_connectionCount;
+    removeFinishedSessions();
+
+    // each connection is handled in its own thread
+    auto session = boost::make_shared<RebotDummySession>(*this, incomingConnection);
+    std::lock_guard<std::mutex> lock(_sessionsMutex);
+    _sessions.emplace_back(session, std::thread([session] {
+      // the terminate signal must interrupt the accept in the main thread
+      sigset_t signalSet;
+      sigemptyset(&signalSet);
+      sigaddset(&signalSet, SIGTERM);
+      pthread_sigmask(SIG_BLOCK, &signalSet, nullptr);
+      session->run();
+    }));
+  }
+
+  // end all connections
+  std::lock_guard<std::mutex> lock(_sessionsMutex);
+  for (auto &session : _sessions) {
+    session.first->shutdown();
+    session.second.join();
+  }
+  _sessions.clear();
+}
+
+void RebotDummyServer::removeFinishedSessions() {
+  std::lock_guard<std::mutex> lock(_sessionsMutex);
+  for (auto it = _sessions.begin(); it != _sessions.end();) {
+    if (it->first->_finished) {
+      it->second.join();
+      it = _sessions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void RebotDummyServer::setLatency(std::chrono::microseconds latency) {
+  _latency = latency;
+}
+
+void RebotDummyServer::setBandwidthLimit(uint64_t bytesPerSecond) {
+  _bandwidthLimit = bytesPerSecond;
+}
+
+void RebotDummyServer::printStatistics(std::ostream &stream) {
+  static const char* commandNames[N_COUNTED_COMMANDS] = {
+      "SINGLE_WORD_READ", "SINGLE_WORD_WRITE", "MULTI_WORD_WRITE", "MULTI_WORD_READ", "HELLO",
+      "PING", "SET_SESSION_TIMEOUT", "MULTI_RANGE_READ", "MULTI_RANGE_WRITE", "unknown"};
+
+  stream << "RebotDummyServer statistics:" << std::endl;
+  stream << "  connections:    " << _connectionCount << std::endl;
+  stream << "  bytes received: " << _bytesReceived << std::endl;
+  stream << "  bytes sent:     " << _bytesSent << std::endl;
+  for (uint32_t i = 0; i < N_COUNTED_COMMANDS; ++i) {
+    if (_commandCount[i] > 0) {
+      stream << "  " << commandNames[i] << ": " << _commandCount[i] << std::endl;
+    }
+  }
+}
+
+RebotDummyServer::~RebotDummyServer() {
+  _connectionAcceptor.close();
+
+  // if the server has not been started, there might still be connections
+  std::lock_guard<std::mutex> lock(_sessionsMutex);
+  for (auto &session : _sessions) {
+    session.first->shutdown();
+    session.second.join();
+  }
+}
+
+void RebotDummyServer::stop(){
+  stop_rebot_server=true;
+  // wake up the accept() in start()
+  ::shutdown(_connectionAcceptor.native_handle(), SHUT_RDWR);
+}
+
+/********************************************************************************************************************/
+
+RebotDummySession::RebotDummySession(RebotDummyServer &server,
+                                     boost::shared_ptr<ip::tcp::socket> socket)
+  : _server(server),
+    _registerSpace(server._registerSpace),
+    _currentClientConnection(socket),
+    _finished(false),
+    _state(RebotDummyServer::ACCEPT_NEW_COMMAND) {
+
+  if (server._protocolVersion == 0){
+    _protocolImplementor.reset(new DummyProtocol0(*this));
+  }else if (server._protocolVersion == 1){
+    _protocolImplementor.reset(new DummyProtocol1(*this));
+  }else{
+    _protocolImplementor.reset(new DummyProtocol2(*this));
   }
 }
 
-void RebotDummyServer::processReceivedPackage(std::vector<uint32_t>& buffer) {
-  if (_state == INSIDE_MULTI_WORD_WRITE){
+void RebotDummySession::processReceivedPackage(std::vector<uint32_t>& buffer) {
+  if (_state == RebotDummyServer::INSIDE_MULTI_WORD_WRITE){
     _state = _protocolImplementor->continueMultiWordWrite(buffer);
   }else{// has to be ACCEPT_NEW_COMMAND
 
     // cause an error condition: just don't answer
-    if (_dont_answer){
+    if (_server._dont_answer){
       return;
     }
 
     uint32_t requestedAction = buffer.at(0);
+    ++_server._commandCount[std::min(requestedAction, RebotDummyServer::N_COUNTED_COMMANDS - 1)];
     switch (requestedAction) {
       
-      case SINGLE_WORD_WRITE: 
+      case RebotDummyServer::SINGLE_WORD_WRITE:
         _protocolImplementor->singleWordWrite(buffer);
         break;
-      case  MULTI_WORD_WRITE:
+      case RebotDummyServer::MULTI_WORD_WRITE:
         _state = _protocolImplementor->multiWordWrite(buffer);
         break;
-      case  MULTI_WORD_READ:
+      case RebotDummyServer::MULTI_WORD_READ:
         _protocolImplementor->multiWordRead(buffer);
         break;
-      case  HELLO:
-        ++_helloCount;
+      case RebotDummyServer::MULTI_RANGE_READ:
+        _protocolImplementor->multiRangeRead(buffer);
+        break;
+      case RebotDummyServer::MULTI_RANGE_WRITE:
+        _protocolImplementor->multiRangeWrite(buffer);
+        break;
+      case RebotDummyServer::HELLO:
+        ++_server._helloCount;
         _protocolImplementor->hello(buffer);
         break;
-      case  PING:
-        ++_heartbeatCount;
+      case RebotDummyServer::PING:
+        ++_server._heartbeatCount;
         _protocolImplementor->ping(buffer);
         break;
       default:
         std::cout << "Instruction unknown in all protocol versions " << requestedAction << std::endl;
-        sendSingleWord(UNKNOWN_INSTRUCTION);
+        sendSingleWord(RebotDummyServer::UNKNOWN_INSTRUCTION);
     }
   }
 }
 
-void RebotDummyServer::writeWordToRequestedAddress(
+void RebotDummySession::writeWordToRequestedAddress(
     std::vector<uint32_t>& buffer) {
   uint32_t registerAddress = buffer.at(1); // This is the word offset; since
                                            // dummy device deals with byte
@@ -122,7 +222,7 @@ void RebotDummyServer::writeWordToRequestedAddress(
   _registerSpace.write(bar, registerAddress, &wordToWrite, sizeof(wordToWrite));
 }
 
-void RebotDummyServer::readRegisterAndSendData(std::vector<uint32_t>& buffer) {
+void RebotDummySession::readRegisterAndSendData(std::vector<uint32_t>& buffer) {
   uint32_t registerAddress =
       buffer.at(1); // This is a word offset. convert to bytes before use. FIXME
   registerAddress = registerAddress * 4;
@@ -130,7 +230,7 @@ void RebotDummyServer::readRegisterAndSendData(std::vector<uint32_t>& buffer) {
 
   // send data in two packets instead of one; this is done for test coverage.
   // Let READ_SUCCESS_INDICATION go in the first write and data in the second.
-  sendSingleWord(READ_SUCCESS_INDICATION);
+  sendSingleWord(RebotDummyServer::READ_SUCCESS_INDICATION);
 
   std::vector<int32_t> dataToSend(numberOfWordsToRead);
   uint8_t bar = 0;
@@ -140,63 +240,127 @@ void RebotDummyServer::readRegisterAndSendData(std::vector<uint32_t>& buffer) {
                       numberOfWordsToRead * sizeof(int32_t));
 
   // FIXME: Nothing in protocol to indicate read failure.
-  boost::asio::write(*_currentClientConnection,
-                     boost::asio::buffer(dataToSend));
+  sendData(boost::asio::buffer(dataToSend));
 }
   
-void RebotDummyServer::sendSingleWord(int32_t response) {
-  std::vector<int32_t> data{ response };
-  boost::asio::write(*_currentClientConnection, boost::asio::buffer(data));
+void RebotDummySession::sendSingleWord(int32_t response) {
+  sendData(boost::asio::buffer(&response, sizeof(response)));
 }
 
-RebotDummyServer::~RebotDummyServer() {
-  _connectionAcceptor.close();
+void RebotDummySession::sendData(boost::asio::const_buffer data) {
+  boost::asio::write(*_currentClientConnection, boost::asio::buffer(data));
+  size_t nBytes = boost::asio::buffer_size(data);
+  _server._bytesSent += nBytes;
 
-  // if the terminate signal is caught while waiting for a connection
-  // there is no client connection, so we have to check the pointer here
-  if (_currentClientConnection) {
-    _currentClientConnection->close();
+  // emulate a link with limited bandwidth
+  if (_server._bandwidthLimit > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(nBytes * 1000000 / _server._bandwidthLimit));
   }
 }
 
-void RebotDummyServer::handleAcceptedConnection(
-    boost::shared_ptr<ip::tcp::socket>& incomingSocket) {
+void RebotDummySession::shutdown() {
+  // wakes up a blocking read in run()
+  ::shutdown(_currentClientConnection->native_handle(), SHUT_RDWR);
+}
+
+void RebotDummySession::run() {
   boost::asio::ip::tcp::no_delay option(true);
-  incomingSocket->set_option(option);
-  _currentClientConnection = incomingSocket;
-
-  while (stop_rebot_server == false) { // This loop handles the accepted connection
-
-    std::vector<uint32_t> dataBuffer(BUFFER_SIZE_IN_WORDS);
-    boost::system::error_code errorCode;
-    _currentClientConnection->read_some(boost::asio::buffer(dataBuffer),
-                                        errorCode);
-
-    if (errorCode == boost::asio::error::eof) { // The client has closed the
-                                                // connection; move to the
-                                                // outer  loop to accept new
-                                                // connections
-      _currentClientConnection->close();
-      //std::cout << "connection closed" << std::endl;
-      break;
-    } else if (errorCode && stop_rebot_server) { // reading was interrupted by a
-                                              // terminate signal;
-      // move to the outer loop which will also quit
-      // and end the server gracefully
-      _currentClientConnection->close();
-      std::cout << "Terminate signal detected while reading. Connection "
-                   "closed, will exit now." << std::endl;
-      break;
-    } else if (errorCode) {
-      throw boost::system::system_error(errorCode);
-    }
+  _currentClientConnection->set_option(option);
+
+  // Bytes received but not yet processed. A client can send several requests before reading the responses
+  // (pipelining), so one read_some() can contain more than one request, or only a part of it.
+  std::vector<char> receivedBytes;
+  std::vector<uint32_t> dataBuffer(RebotDummyServer::BUFFER_SIZE_IN_WORDS);
+
+  try {
+    while (stop_rebot_server == false) { // This loop handles the accepted connection
+
+      boost::system::error_code errorCode;
+      size_t nBytesReceived = _currentClientConnection->read_some(boost::asio::buffer(dataBuffer),
+                                                                  errorCode);
+      auto receiveTime = std::chrono::steady_clock::now();
+
+      if (errorCode == boost::asio::error::eof) { // The client has closed the
+                                                  // connection
+        break;
+      } else if (errorCode && stop_rebot_server) { // reading was interrupted by a
+                                                   // terminate signal
+        std::cout << "Terminate signal detected while reading. Connection "
+                     "closed, will exit now." << std::endl;
+        break;
+      } else if (errorCode) {
+        throw boost::system::system_error(errorCode);
+      }
 
-    processReceivedPackage(dataBuffer);
+      _server._bytesReceived += nBytesReceived;
+      auto receivedData = reinterpret_cast<char*>(dataBuffer.data());
+      receivedBytes.insert(receivedBytes.end(), receivedData, receivedData + nBytesReceived);
+
+      // process all complete requests
+      size_t nBytesProcessed = 0;
+      while (true) {
+        size_t nWordsAvailable = (receivedBytes.size() - nBytesProcessed) / sizeof(uint32_t);
+        auto words = reinterpret_cast<const uint32_t*>(receivedBytes.data() + nBytesProcessed);
+        size_t requestLength = getRequestLength(words, nWordsAvailable);
+        if (requestLength == 0 || requestLength > nWordsAvailable) break;
+        std::vector<uint32_t> request(words, words + requestLength);
+        nBytesProcessed += requestLength * sizeof(uint32_t);
+
+        // emulate the network latency
+        if (_server._latency.count() > 0) {
+          std::this_thread::sleep_until(receiveTime + _server._latency);
+        }
+        processReceivedPackage(request);
+      }
+      receivedBytes.erase(receivedBytes.begin(), receivedBytes.begin() + nBytesProcessed);
+    }
   }
+  catch (std::exception &e) {
+    std::cout << "RebotDummyServer: Closing connection after error: " << e.what() << std::endl;
+  }
+
+  boost::system::error_code ignoredError;
+  _currentClientConnection->close(ignoredError);
+  _finished = true;
 }
 
-void RebotDummyServer::stop(){
-  stop_rebot_server=true;
+size_t RebotDummySession::getRequestLength(const uint32_t *words, size_t nWordsAvailable) {
+  if (nWordsAvailable == 0) {
+    return 0;
+  }
+  switch (words[0]) {
+    case RebotDummyServer::SINGLE_WORD_WRITE:
+    case RebotDummyServer::MULTI_WORD_READ:
+    case RebotDummyServer::HELLO:
+      return 3;
+    case RebotDummyServer::MULTI_WORD_WRITE:
+      // the header contains the number of words to write
+      if (nWordsAvailable < 3) {
+        return 0;
+      }
+      return 3 + words[2];
+    case RebotDummyServer::MULTI_RANGE_READ:
+      if (nWordsAvailable < 2) {
+        return 0;
+      }
+      return 2 + 2 * size_t(words[1]);
+    case RebotDummyServer::MULTI_RANGE_WRITE: {
+      // the list of ranges is followed by the data
+      if (nWordsAvailable < 2 || nWordsAvailable < 2 + 2 * size_t(words[1])) {
+        return 0;
+      }
+      size_t length = 2 + 2 * size_t(words[1]);
+      for (size_t i = 0; i < words[1]; ++i) {
+        length += words[3 + 2 * i];
+      }
+      return length;
+    }
+    case RebotDummyServer::PING:
+      return 1;
+    default:
+      // unknown instruction: discard everything which has been received
+      return nWordsAvailable;
+  }
 }
 
 } /* namespace ChimeraTK */
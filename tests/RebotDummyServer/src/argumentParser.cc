@@ -5,6 +5,9 @@
 static const unsigned int DEFAULT_SERVER_PORT = 5001;
 static const std::string DEFAULT_MAP_FILE = "./testFile.map";
 static const unsigned int DEFAULT_PROTOCOL_VERSION = 0x0;
+static const unsigned int DEFAULT_LATENCY = 0;
+static const unsigned long DEFAULT_BANDWIDTH_LIMIT = 0;
+static const unsigned int DEFAULT_STATISTICS_INTERVAL = 0;
 
 
 /**************************************************************************/
@@ -57,6 +60,45 @@ unsigned int getProtocolVersion(char** argumentArray) {
   }
 }
 
+unsigned int getLatency(char** argumentArray) {
+
+  Argument latencyFlag("-l", "--latency");
+  std::string latency = getArgumentValue(latencyFlag, argumentArray);
+
+  try {
+    return std::stoul(latency);
+  }
+  catch (...) {
+    return DEFAULT_LATENCY;
+  }
+}
+
+unsigned long getBandwidthLimit(char** argumentArray) {
+
+  Argument bandwidthFlag("-b", "--bandwidth");
+  std::string bandwidth = getArgumentValue(bandwidthFlag, argumentArray);
+
+  try {
+    return std::stoul(bandwidth);
+  }
+  catch (...) {
+    return DEFAULT_BANDWIDTH_LIMIT;
+  }
+}
+
+unsigned int getStatisticsInterval(char** argumentArray) {
+
+  Argument statisticsIntervalFlag("-s", "--statistics-interval");
+  std::string statisticsInterval = getArgumentValue(statisticsIntervalFlag, argumentArray);
+
+  try {
+    return std::stoul(statisticsInterval);
+  }
+  catch (...) {
+    return DEFAULT_STATISTICS_INTERVAL;
+  }
+}
+
 std::string getArgumentValue(Argument& argument, char** argumentArray) {
   if (*argumentArray == nullptr || *(argumentArray + 1) == nullptr) {
     return std::string();
@@ -4,6 +4,12 @@
 #include <algorithm>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <poll.h>
 
 #include <boost/thread.hpp>
 
@@ -13,6 +19,8 @@
 #include "DeviceAccessVersion.h"
 #include "ExperimentalFeatures.h"
 #include "NDRegisterAccessorDecorator.h"
+#include "ReadAsyncThreadPool.h"
+#include "ReadAnyGroup.h"
 
 namespace mtca4u{
   using namespace ChimeraTK;
@@ -44,11 +52,16 @@ class AsyncDefaultImplTestDummy : public DummyBackend {
       while(!readMutex.at(address).try_lock_for(std::chrono::milliseconds(100))) {
         boost::this_thread::interruption_point();
       }
-      DummyBackend::read(bar,address,data,sizeInBytes);
+      bool fail = (address == failingAddress);
+      if(!fail) DummyBackend::read(bar,address,data,sizeInBytes);
       readMutex.at(address).unlock();
+      if(fail) throw DeviceException("Read failure for testing", DeviceException::NOT_AVAILABLE);
     }
 
     std::map<int, std::timed_mutex> readMutex;
+
+    /// reads of this address throw an exception
+    std::atomic<uint32_t> failingAddress{0xFFFFFFFF};
 };
 
 /**********************************************************************************************************************/
@@ -76,6 +89,53 @@ class AsyncTestDummy : public AsyncDefaultImplTestDummy {
 
 };
 
+/**********************************************************************************************************************/
+
+/** Decorator which does not support setReadyListener(), to test the fallback of the ReadAnyGroup */
+class NoReadyListenerDecorator : public NDRegisterAccessorDecorator<int32_t> {
+  public:
+    using NDRegisterAccessorDecorator<int32_t>::NDRegisterAccessorDecorator;
+
+    bool setReadyListener(std::function<void()>) override {
+      return false;
+    }
+};
+
+/**********************************************************************************************************************/
+
+/** Simple event loop serving as executor for the completion handlers */
+class TestEventLoop {
+  public:
+    TransferExecutor getExecutor() {
+      return [this](std::function<void()> function) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(function));
+        condition.notify_one();
+      };
+    }
+
+    /// Execute functions posted to the loop until the given flag is set or the timeout expires
+    void runUntil(std::atomic<bool> &flag) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      std::unique_lock<std::mutex> lock(mutex);
+      while(!flag) {
+        if(queue.empty()) {
+          if(condition.wait_until(lock, deadline) == std::cv_status::timeout) return;
+          continue;
+        }
+        auto function = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        function();
+        lock.lock();
+      }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> queue;
+};
+
 /**********************************************************************************************************************/
 class AsyncReadTest {
   public:
@@ -89,6 +149,21 @@ class AsyncReadTest {
     /// test mixing the various read functions
     void testMixing();
 
+    /// test that the transfers are executed by the persistent threads of the ReadAsyncThreadPool
+    void testThreadPool();
+
+    /// test the ReadAnyGroup
+    void testReadAnyGroup();
+
+    /// test the TransferFuture::ReusablePromise
+    void testReusablePromise();
+
+    /// test waiting for new data with poll() on the wait handles
+    void testWaitHandle();
+
+    /// test readAsync() and writeAsync() with completion handlers
+    void testCompletionHandlers();
+
 };
 
 /**********************************************************************************************************************/
@@ -101,6 +176,11 @@ class  AsyncReadTestSuite : public test_suite {
       add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testAsyncRead, asyncReadTest ) );
       add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testReadAny, asyncReadTest ) );
       add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testMixing, asyncReadTest ) );
+      add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testThreadPool, asyncReadTest ) );
+      add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testReadAnyGroup, asyncReadTest ) );
+      add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testReusablePromise, asyncReadTest ) );
+      add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testWaitHandle, asyncReadTest ) );
+      add( BOOST_CLASS_TEST_CASE( &AsyncReadTest::testCompletionHandlers, asyncReadTest ) );
     }};
 
 /**********************************************************************************************************************/
@@ -520,3 +600,440 @@ void AsyncReadTest::testMixing() {
     device.close();
   }
 }
+
+/**********************************************************************************************************************/
+void AsyncReadTest::testThreadPool() {
+
+  for(auto &sdmToUse : sdmList) {
+    std::cout << "testThreadPool: " << sdmToUse << std::endl;
+
+    Device device;
+    device.open(sdmToUse);
+    auto backend = boost::dynamic_pointer_cast<AsyncDefaultImplTestDummy>(BackendFactory::getInstance().createBackend(sdmToUse));
+    BOOST_CHECK( backend != NULL );
+
+    auto accessor = device.getScalarRegisterAccessor<int>("APP0/WORD_STATUS");
+    DummyRegisterAccessor<int> dummy(backend.get(),"APP0","WORD_STATUS");
+    backend->readMutex[0x08].unlock();
+
+    // repeated transfers are executed by the same workers, no new threads are started
+    accessor.readAsync().wait();
+    auto &pool = ReadAsyncThreadPool::getInstance();
+    size_t nThreads = pool.getNumberOfThreads();
+    BOOST_CHECK( nThreads > 0 );
+    for(int i=0; i<100; ++i) {
+      dummy = i;
+      accessor.readAsync().wait();
+      BOOST_CHECK( accessor == i );
+    }
+    BOOST_CHECK_EQUAL( pool.getNumberOfThreads(), nThreads );
+
+    // exceptions thrown in the transfer are passed on to the waiting thread (the AsyncDefaultImplTestDummy throws
+    // std::out_of_range for addresses without a mutex)
+    auto firmware = device.getScalarRegisterAccessor<int>("BOARD/WORD_FIRMWARE");
+    BOOST_CHECK_THROW( firmware.readAsync().wait(), std::out_of_range );
+
+    // after the exception, the accessor can be used again
+    backend->readMutex[0x00].unlock();
+    DummyRegisterAccessor<int> dummyFirmware(backend.get(),"BOARD","WORD_FIRMWARE");
+    dummyFirmware = 77;
+    firmware.readAsync().wait();
+    BOOST_CHECK( firmware == 77 );
+
+    // an accessor can be destroyed while its transfer is still blocked in the pool
+    backend->readMutex[0x08].lock();
+    {
+      auto blocked = device.getScalarRegisterAccessor<int>("APP0/WORD_STATUS");
+      blocked.readAsync();
+    }
+    backend->readMutex[0x08].unlock();
+
+    // the worker is available again afterwards
+    dummy = 123;
+    accessor.readAsync().wait();
+    BOOST_CHECK( accessor == 123 );
+
+    device.close();
+  }
+
+  // workers exceeding the maximum number of threads exit once they become idle
+  auto &pool = ReadAsyncThreadPool::getInstance();
+  size_t maxNumberOfThreads = pool.getMaxNumberOfThreads();
+  std::mutex blockingMutex;
+  std::unique_lock<std::mutex> blockingLock(blockingMutex);
+  std::atomic<size_t> nBlocked{0}, nDone{0};
+  for(int i=0; i<4; ++i) {
+    pool.post([&] {
+      {
+        ReadAsyncThreadPool::BlockingSection blocking;
+        ++nBlocked;
+        std::lock_guard<std::mutex> lock(blockingMutex);
+      }
+      ++nDone;
+    });
+  }
+  for(size_t i=0; i<500 && nBlocked < 4; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL( nBlocked.load(), 4 );
+  BOOST_CHECK( pool.getNumberOfThreads() >= 4 );
+  pool.setMaxNumberOfThreads(1);
+  blockingLock.unlock();
+  for(size_t i=0; i<500 && (nDone < 4 || pool.getNumberOfThreads() > 1); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_CHECK_EQUAL( nDone.load(), 4 );
+  BOOST_CHECK_EQUAL( pool.getNumberOfThreads(), 1 );
+  pool.setMaxNumberOfThreads(maxNumberOfThreads);
+}
+
+/**********************************************************************************************************************/
+void AsyncReadTest::testReadAnyGroup() {
+
+  for(auto &sdmToUse : sdmList) {
+    std::cout << "testReadAnyGroup: " << sdmToUse << std::endl;
+
+    Device device;
+    device.open(sdmToUse);
+    auto backend = boost::dynamic_pointer_cast<AsyncDefaultImplTestDummy>(BackendFactory::getInstance().createBackend(sdmToUse));
+    BOOST_CHECK( backend != NULL );
+
+    auto a1 = device.getScalarRegisterAccessor<int32_t>("MODULE0/WORD_USER2");
+    auto a2 = device.getScalarRegisterAccessor<int32_t>("MODULE1/WORD_USER1");
+    auto a3 = device.getScalarRegisterAccessor<int32_t>("MODULE1/WORD_USER2");
+
+    DummyRegisterAccessor<int32_t> dummy1(backend.get(),"MODULE0","WORD_USER2");
+    DummyRegisterAccessor<int32_t> dummy2(backend.get(),"MODULE1","WORD_USER1");
+    DummyRegisterAccessor<int32_t> dummy3(backend.get(),"MODULE1","WORD_USER2");
+
+    // lock all mutexes so no read can complete
+    backend->readMutex[0x14].lock();
+    backend->readMutex[0x20].lock();
+    backend->readMutex[0x24].lock();
+
+    dummy1 = 10;
+    dummy2 = 20;
+    dummy3 = 30;
+
+    {
+      ReadAnyGroup group({a1,a2,a3});
+
+      // readAny() blocks until one transfer has completed
+      for(int i=0; i<3; ++i) {
+        std::atomic<bool> flag{false};
+        TransferElementID id;
+        std::thread thread([&group,&flag,&id] { id = group.readAny(); flag = true; });
+        usleep(100000);
+        BOOST_CHECK(flag == false);
+
+        dummy2 = 20+i;
+        backend->readMutex[0x20].unlock();
+        thread.join();
+        BOOST_CHECK( id == a2.getId() );
+        BOOST_CHECK( a2 == 20+i );
+        backend->readMutex[0x20].lock();
+      }
+
+      // complete two transfers before calling readAny(): the older one is returned first
+      backend->readMutex[0x24].unlock();
+      usleep(100000);
+      backend->readMutex[0x24].lock();
+      backend->readMutex[0x14].unlock();
+      usleep(100000);
+      backend->readMutex[0x14].lock();
+      BOOST_CHECK( group.readAny() == a3.getId() );
+      BOOST_CHECK( a3 == 30 );
+      BOOST_CHECK( group.readAny() == a1.getId() );
+      BOOST_CHECK( a1 == 10 );
+
+      // the transfers of a1 and a3 are started again by the next readAny()
+      dummy1 = 11;
+      backend->readMutex[0x14].unlock();
+      BOOST_CHECK( group.readAny() == a1.getId() );
+      BOOST_CHECK( a1 == 11 );
+      backend->readMutex[0x14].lock();
+    }
+
+    // the group has left transfers running in the background: complete them before using the accessors again
+    backend->readMutex[0x14].unlock();
+    backend->readMutex[0x20].unlock();
+    backend->readMutex[0x24].unlock();
+    a1.read();
+    a2.read();
+    a3.read();
+
+    // an element without support for setReadyListener() lets the group fall back to the plain readAny()
+    ScalarRegisterAccessor<int32_t> undecorated = device.getScalarRegisterAccessor<int32_t>("MODULE0/WORD_USER2");
+    ScalarRegisterAccessor<int32_t> decorated(boost::make_shared<NoReadyListenerDecorator>(
+        boost::dynamic_pointer_cast<NDRegisterAccessor<int32_t>>(undecorated.getHighLevelImplElement())));
+    backend->readMutex[0x20].lock();
+    dummy1 = 12;
+    {
+      ReadAnyGroup group({decorated,a2});
+      BOOST_CHECK( group.readAny() == decorated.getId() );
+      BOOST_CHECK( decorated == 12 );
+    }
+    backend->readMutex[0x20].unlock();
+    decorated.read();
+    a2.read();
+
+    // an exception is reported before older updates, also if it is not the first ready element
+    backend->readMutex[0x14].lock();
+    backend->readMutex[0x20].lock();
+    backend->readMutex[0x24].lock();
+    {
+      ReadAnyGroup group({a1,a2,a3});
+      backend->readMutex[0x20].unlock();
+      BOOST_CHECK( group.readAny() == a2.getId() );
+      backend->readMutex[0x20].lock();
+
+      // a1 completes first, then the transfer of a3 fails
+      dummy1 = 13;
+      backend->readMutex[0x14].unlock();
+      usleep(100000);
+      backend->readMutex[0x14].lock();
+      backend->failingAddress = 0x24;
+      backend->readMutex[0x24].unlock();
+      usleep(100000);
+      BOOST_CHECK_THROW( group.readAny(), std::exception );
+      backend->failingAddress = 0xFFFFFFFF;
+
+      // the older update is still delivered afterwards
+      BOOST_CHECK( group.readAny() == a1.getId() );
+      BOOST_CHECK( a1 == 13 );
+    }
+    backend->readMutex[0x14].unlock();
+    backend->readMutex[0x20].unlock();
+    a1.read();
+    a2.read();
+    a3.read();
+
+    device.close();
+  }
+}
+
+/**********************************************************************************************************************/
+void AsyncReadTest::testReusablePromise() {
+
+  // use the promise directly, without a TransferElement
+  TransferFuture::ReusablePromise promise;
+  TransferFuture::Data data1{VersionNumber()};
+  TransferFuture::Data data2{VersionNumber()};
+
+  for(int i=0; i<3; ++i) {
+    promise.reset();
+    BOOST_CHECK( !promise.isReady() );
+
+    // the boost future is only created on request (here in the second round)
+    TransferFuture::PlainFutureType boostFuture;
+    if(i == 1) boostFuture = TransferFuture(promise, nullptr).getBoostFuture();
+
+    // wait() blocks until the promise is fulfilled from another thread
+    std::atomic<bool> flag{false};
+    std::thread thread([&promise,&flag] { promise.wait(); flag = true; });
+    usleep(100000);
+    BOOST_CHECK(flag == false);
+    promise.setValue(i%2 ? &data2 : &data1);
+    thread.join();
+    BOOST_CHECK( promise.isReady() );
+    BOOST_CHECK( !promise.hasException() );
+    BOOST_CHECK( promise.getData() == (i%2 ? &data2 : &data1) );
+
+    if(i == 1) {
+      BOOST_CHECK( boostFuture.is_ready() );
+      BOOST_CHECK( boostFuture.get() == &data2 );
+    }
+  }
+
+  // the boost future is also fulfilled if requested after the promise was fulfilled, also with an exception
+  promise.reset();
+  try {
+    throw std::runtime_error("test");
+  }
+  catch(...) {
+    promise.setException(boost::current_exception());
+  }
+  BOOST_CHECK( promise.isReady() );
+  BOOST_CHECK( promise.hasException() );
+  auto boostFuture = TransferFuture(promise, nullptr).getBoostFuture();
+  BOOST_CHECK( boostFuture.is_ready() );
+  BOOST_CHECK( boostFuture.has_exception() );
+
+  // accessors using the SyncNDRegisterAccessor reuse the same promise for each transfer
+  for(auto &sdmToUse : sdmList) {
+    std::cout << "testReusablePromise: " << sdmToUse << std::endl;
+
+    Device device;
+    device.open(sdmToUse);
+    auto backend = boost::dynamic_pointer_cast<AsyncDefaultImplTestDummy>(BackendFactory::getInstance().createBackend(sdmToUse));
+    BOOST_CHECK( backend != NULL );
+
+    auto accessor = device.getScalarRegisterAccessor<int>("APP0/WORD_STATUS");
+    DummyRegisterAccessor<int> dummy(backend.get(),"APP0","WORD_STATUS");
+    backend->readMutex[0x08].unlock();
+
+    VersionNumber lastVersion;
+    for(int i=0; i<5; ++i) {
+      dummy = i;
+      backend->readMutex[0x08].lock();
+      auto future = accessor.readAsync();
+      BOOST_CHECK( !future.hasNewData() );
+      backend->readMutex[0x08].unlock();
+      while(!future.hasNewData()) usleep(1000);
+      BOOST_CHECK( !future.hasException() );
+      BOOST_CHECK( lastVersion < future.getVersionNumber() );
+      lastVersion = future.getVersionNumber();
+      future.wait();
+      BOOST_CHECK( accessor == i );
+    }
+
+    device.close();
+  }
+}
+
+/**********************************************************************************************************************/
+void AsyncReadTest::testWaitHandle() {
+
+  for(auto &sdmToUse : sdmList) {
+    std::cout << "testWaitHandle: " << sdmToUse << std::endl;
+
+    Device device;
+    device.open(sdmToUse);
+    auto backend = boost::dynamic_pointer_cast<AsyncDefaultImplTestDummy>(BackendFactory::getInstance().createBackend(sdmToUse));
+    BOOST_CHECK( backend != NULL );
+
+    auto a1 = device.getScalarRegisterAccessor<int32_t>("MODULE0/WORD_USER2");
+    auto a2 = device.getScalarRegisterAccessor<int32_t>("MODULE1/WORD_USER1");
+    DummyRegisterAccessor<int32_t> dummy1(backend.get(),"MODULE0","WORD_USER2");
+    DummyRegisterAccessor<int32_t> dummy2(backend.get(),"MODULE1","WORD_USER1");
+
+    backend->readMutex[0x14].lock();
+    backend->readMutex[0x20].lock();
+    dummy1 = 1;
+    dummy2 = 2;
+
+    struct pollfd fds[2];
+    fds[0].fd = a1.getWaitHandle();
+    fds[1].fd = a2.getWaitHandle();
+    BOOST_CHECK( fds[0].fd >= 0 );
+    BOOST_CHECK( fds[1].fd >= 0 );
+    BOOST_CHECK( fds[0].fd != fds[1].fd );
+    fds[0].events = fds[1].events = POLLIN;
+
+    // nothing is readable while the transfers are blocked
+    BOOST_CHECK_EQUAL( poll(fds, 2, 100), 0 );
+
+    // complete the transfer of a2
+    backend->readMutex[0x20].unlock();
+    BOOST_CHECK_EQUAL( poll(fds, 2, 5000), 1 );
+    BOOST_CHECK( !(fds[0].revents & POLLIN) );
+    BOOST_CHECK( fds[1].revents & POLLIN );
+    BOOST_CHECK( a2.readNonBlocking() );
+    BOOST_CHECK( a2 == 2 );
+    backend->readMutex[0x20].lock();
+
+    // the next call starts the next transfer with the same handle, which is not readable until it completes
+    BOOST_CHECK_EQUAL( a2.getWaitHandle(), fds[1].fd );
+    BOOST_CHECK_EQUAL( poll(fds, 2, 100), 0 );
+
+    // complete the transfer of a1
+    dummy1 = 11;
+    backend->readMutex[0x14].unlock();
+    BOOST_CHECK_EQUAL( poll(fds, 2, 5000), 1 );
+    BOOST_CHECK( fds[0].revents & POLLIN );
+    BOOST_CHECK( !(fds[1].revents & POLLIN) );
+    BOOST_CHECK( a1.readNonBlocking() );
+    BOOST_CHECK( a1 == 11 );
+
+    // complete the transfer of a2 to leave the accessors in a clean state
+    backend->readMutex[0x20].unlock();
+    a2.read();
+
+    device.close();
+  }
+}
+
+/**********************************************************************************************************************/
+void AsyncReadTest::testCompletionHandlers() {
+
+  for(auto &sdmToUse : sdmList) {
+    std::cout << "testCompletionHandlers: " << sdmToUse << std::endl;
+
+    Device device;
+    device.open(sdmToUse);
+    auto backend = boost::dynamic_pointer_cast<AsyncDefaultImplTestDummy>(BackendFactory::getInstance().createBackend(sdmToUse));
+    BOOST_CHECK( backend != NULL );
+
+    TestEventLoop loop;
+    auto a1 = device.getScalarRegisterAccessor<int32_t>("MODULE0/WORD_USER2");
+    auto a2 = device.getScalarRegisterAccessor<int32_t>("MODULE1/WORD_USER1");
+    DummyRegisterAccessor<int32_t> dummy1(backend.get(),"MODULE0","WORD_USER2");
+    DummyRegisterAccessor<int32_t> dummy2(backend.get(),"MODULE1","WORD_USER1");
+    backend->readMutex[0x14].lock();
+    backend->readMutex[0x20].unlock();
+
+    // read two registers from the same thread, the blocked one does not hold up the other one
+    dummy1 = 1;
+    dummy2 = 2;
+    std::atomic<bool> done1{false}, done2{false};
+    a1.readAsync(loop.getExecutor(), [&](boost::exception_ptr e) { BOOST_CHECK( !e ); done1 = true; });
+    a2.readAsync(loop.getExecutor(), [&](boost::exception_ptr e) { BOOST_CHECK( !e ); done2 = true; });
+    loop.runUntil(done2);
+    BOOST_CHECK( done2 );
+    BOOST_CHECK( !done1 );
+    BOOST_CHECK( a2 == 2 );
+    backend->readMutex[0x14].unlock();
+    loop.runUntil(done1);
+    BOOST_CHECK( done1 );
+    BOOST_CHECK( a1 == 1 );
+
+    // write asynchronously: the user buffer can be changed right after the call
+    std::atomic<bool> written{false};
+    a2 = 42;
+    a2.writeAsync(loop.getExecutor(), [&](bool dataLost, boost::exception_ptr e) {
+      BOOST_CHECK( !dataLost );
+      BOOST_CHECK( !e );
+      written = true;
+    });
+    a2 = 0;
+    loop.runUntil(written);
+    BOOST_CHECK( written );
+    BOOST_CHECK( dummy2 == 42 );
+
+    // exceptions are passed to the handler (the AsyncDefaultImplTestDummy throws std::out_of_range for addresses
+    // without a mutex)
+    auto firmware = device.getScalarRegisterAccessor<int32_t>("BOARD/WORD_FIRMWARE");
+    std::atomic<bool> failed{false};
+    firmware.readAsync(loop.getExecutor(), [&](boost::exception_ptr e) {
+      BOOST_CHECK_THROW( boost::rethrow_exception(e), std::out_of_range );
+      failed = true;
+    });
+    loop.runUntil(failed);
+    BOOST_CHECK( failed );
+
+    // futures constructed from a plain boost future are waited for in the ReadAsyncThreadPool. These waits must not
+    // occupy the limited threads, so more of them than there are threads do not hold up other transfers.
+    auto &pool = ReadAsyncThreadPool::getInstance();
+    size_t maxNumberOfThreads = pool.getMaxNumberOfThreads();
+    pool.setMaxNumberOfThreads(1);
+    std::vector<TransferFuture::PromiseType> promises(pool.getNumberOfThreads() + 2);
+    std::atomic<size_t> nContinued{0};
+    for(auto &promise : promises) {
+      TransferFuture future(promise.get_future().share(), nullptr);
+      future.then([&nContinued] { ++nContinued; });
+    }
+    std::atomic<bool> done3{false};
+    dummy2 = 3;
+    a2.readAsync(loop.getExecutor(), [&](boost::exception_ptr e) { BOOST_CHECK( !e ); done3 = true; });
+    loop.runUntil(done3);
+    BOOST_CHECK( done3 );
+    BOOST_CHECK( a2 == 3 );
+    TransferFuture::Data data{{}};
+    for(auto &promise : promises) promise.set_value(&data);
+    for(size_t i=0; i<500 && nContinued < promises.size(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL( nContinued.load(), promises.size() );
+    pool.setMaxNumberOfThreads(maxNumberOfThreads);
+
+    device.close();
+  }
+}
@@ -5,6 +5,9 @@
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
+#include <atomic>
+#include <thread>
+
 #include "BackendFactory.h"
 #include "DummyBackend.h"
 #include "NotImplementedException.h"
@@ -59,10 +62,12 @@ class DummyBackendTest {
 
     void testReadWriteSingleWordRegister();
     void testReadWriteMultiWordRegister();
+    void testConcurrentRead();
     void testReadDeviceInfo();
     void testReadOnly();
     void testWriteCallbackFunctions();
     void testIsWriteRangeOverlap();
+    void testAddressRangeIndex();
     void testWriteRegisterWithoutCallback();
 
     /// Test that all registers, read-only flags and callback functions are removed
@@ -114,8 +119,10 @@ class DummyBackendTestSuite : public test_suite {
       test_case* testAddressRange = BOOST_TEST_CASE(DummyBackendTest::testAddressRange);
       test_case* testReadWriteSingleWordRegister = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testReadWriteSingleWordRegister, dummyBackendTest);
       test_case* testReadWriteMultiWordRegister = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testReadWriteMultiWordRegister, dummyBackendTest);
+      test_case* testConcurrentRead = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testConcurrentRead, dummyBackendTest);
       test_case* testReadDeviceInfo = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testReadDeviceInfo, dummyBackendTest);
       test_case* testIsWriteRangeOverlap = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testIsWriteRangeOverlap, dummyBackendTest);
+      test_case* testAddressRangeIndex = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testAddressRangeIndex, dummyBackendTest);
       test_case* testFinalClosing = BOOST_CLASS_TEST_CASE(&DummyBackendTest::testFinalClosing, dummyBackendTest);
 
       // we use the setup from the read-only test to check that the callback
@@ -124,12 +131,14 @@ class DummyBackendTestSuite : public test_suite {
       testAddressRange->depends_on(testCheckSizeIsMultipleOfWordSize);
       testReadWriteSingleWordRegister->depends_on(testAddressRange);
       testReadWriteMultiWordRegister->depends_on(testReadWriteSingleWordRegister);
-      testReadDeviceInfo->depends_on(testReadWriteMultiWordRegister);
+      testConcurrentRead->depends_on(testReadWriteMultiWordRegister);
+      testReadDeviceInfo->depends_on(testConcurrentRead);
       readOnlyTestCase->depends_on(testReadDeviceInfo);
       writeCallbackFunctionsTestCase->depends_on(readOnlyTestCase);
       writeRegisterWithoutCallbackTestCase->depends_on(writeCallbackFunctionsTestCase);
       testIsWriteRangeOverlap->depends_on(writeRegisterWithoutCallbackTestCase);
-      testFinalClosing->depends_on(testIsWriteRangeOverlap);
+      testAddressRangeIndex->depends_on(testIsWriteRangeOverlap);
+      testFinalClosing->depends_on(testAddressRangeIndex);
       createBackendTestCase->depends_on(testFinalClosing);
       openTestCase->depends_on(createBackendTestCase);
       closeTestCase->depends_on(openTestCase);
@@ -140,11 +149,13 @@ class DummyBackendTestSuite : public test_suite {
       add(testAddressRange);
       add(testReadWriteSingleWordRegister);
       add(testReadWriteMultiWordRegister);
+      add(testConcurrentRead);
       add(testReadDeviceInfo);
       add(readOnlyTestCase);
       add(writeCallbackFunctionsTestCase);
       add(writeRegisterWithoutCallbackTestCase);
       add(testIsWriteRangeOverlap);
+      add(testAddressRangeIndex);
       add(testFinalClosing);
       add(createBackendTestCase);
       add(openTestCase);
@@ -261,6 +272,57 @@ void DummyBackendTest::testReadWriteMultiWordRegister() {
   BOOST_CHECK_THROW( dummyBackend->write(bar, offset, &(dataContent[0]), sizeInBytes - 1), DummyBackendException);
 }
 
+void DummyBackendTest::testConcurrentRead() {
+  TestableDummyBackend* dummyBackend = getBackendInstance(true);
+  RegisterInfoMap::RegisterInfo mappingElement;
+  dummyBackend->_registerMapping->getRegisterInfo(CLOCK_MUX_REGISTER_STRING, mappingElement);
+  uint32_t offset = mappingElement.address;
+  uint8_t bar = mappingElement.bar;
+  size_t sizeInWords = mappingElement.nBytes / sizeof(int32_t);
+  BOOST_REQUIRE(sizeInWords > 1);
+
+  // the write callback functions are still executed
+  std::atomic<int> nCallbacks(0);
+  dummyBackend->setWriteCallbackFunction(
+      TestableDummyBackend::AddressRange(bar, offset, mappingElement.nBytes), [&nCallbacks] { ++nCallbacks; });
+
+  // Each write sets all words of the register to the same value. Readers must never see a mixture of two writes.
+  const int nWrites = 10000;
+  std::vector<int32_t> writeData(sizeInWords, 0);
+  dummyBackend->write(bar, offset, writeData.data(), mappingElement.nBytes);
+  std::atomic<bool> writerFinished(false);
+  std::atomic<int> nInconsistentReads(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      std::vector<int32_t> readData(sizeInWords);
+      while (!writerFinished) {
+        dummyBackend->read(bar, offset, readData.data(), mappingElement.nBytes);
+        for (auto value : readData) {
+          if (value != readData[0]) {
+            ++nInconsistentReads;
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (int i = 1; i <= nWrites; ++i) {
+    std::fill(writeData.begin(), writeData.end(), i);
+    dummyBackend->write(bar, offset, writeData.data(), mappingElement.nBytes);
+  }
+  writerFinished = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  BOOST_CHECK_EQUAL(nInconsistentReads, 0);
+  BOOST_CHECK_EQUAL(nCallbacks, nWrites + 1);
+
+  // remove the callback function again
+  getBackendInstance(true);
+}
+
 TestableDummyBackend* DummyBackendTest::getBackendInstance(bool reOpen) {
   if (_backendInstance == 0)
     _backendInstance = FactoryInstance.createBackend(EXISTING_DEVICE);
@@ -497,17 +559,82 @@ void DummyBackendTest::testIsWriteRangeOverlap() {
   BOOST_CHECK(overlap == false);
 }
 
+void DummyBackendTest::testAddressRangeIndex() {
+  // use a fresh backend, testFinalClosing() needs read-only and callback settings again afterwards
+  TestableDummyBackend dummyBackend(TEST_MAPPING_FILE);
+  dummyBackend.open();
+  uint8_t bar = 2;
+  std::vector<int32_t> dataContent(16, 0);
+  dummyBackend.write(bar, 0, dataContent.data(), 4 * dataContent.size());
+
+  // adjacent and overlapping read-only ranges are merged
+  dummyBackend.setReadOnly(bar, 0, 1);
+  dummyBackend.setReadOnly(bar, 8, 1);
+  BOOST_CHECK_EQUAL(dummyBackend._readOnlyRanges.size(), 2);
+  dummyBackend.setReadOnly(bar, 4, 1);
+  BOOST_CHECK_EQUAL(dummyBackend._readOnlyRanges.size(), 1);
+  dummyBackend.setReadOnly(bar, 40, 2);
+  dummyBackend.setReadOnly(bar, 40, 1);
+  BOOST_CHECK_EQUAL(dummyBackend._readOnlyRanges.size(), 2);
+
+  // callbacks are only executed if at least one of the written registers in their range is writeable
+  int nCallsA = 0, nCallsB = 0, nCallsC = 0, nCallsD = 0;
+  dummyBackend.setWriteCallbackFunction(TestableDummyBackend::AddressRange(bar, 0, 12), [&nCallsA] { ++nCallsA; });
+  dummyBackend.setWriteCallbackFunction(TestableDummyBackend::AddressRange(bar, 8, 16), [&nCallsB] { ++nCallsB; });
+  dummyBackend.setWriteCallbackFunction(TestableDummyBackend::AddressRange(bar, 40, 8), [&nCallsC] { ++nCallsC; });
+  dummyBackend.setWriteCallbackFunction(TestableDummyBackend::AddressRange(bar, 44, 100), [&nCallsD] { ++nCallsD; });
+
+  std::fill(dataContent.begin(), dataContent.end(), 7);
+  dummyBackend.write(bar, 0, dataContent.data(), 4 * dataContent.size());
+  BOOST_CHECK_EQUAL(nCallsA, 0);
+  BOOST_CHECK_EQUAL(nCallsB, 1);
+  BOOST_CHECK_EQUAL(nCallsC, 0);
+  BOOST_CHECK_EQUAL(nCallsD, 1);
+
+  dummyBackend.read(bar, 0, dataContent.data(), 4 * dataContent.size());
+  for (size_t i = 0; i < dataContent.size(); ++i) {
+    bool readOnly = (i < 3 || i == 10 || i == 11);
+    BOOST_CHECK_EQUAL(dataContent[i], readOnly ? 0 : 7);
+  }
+
+  // writing only read-only registers triggers no callback, writing a single writeable word only the matching ones
+  dummyBackend.write(bar, 4, dataContent.data(), 4);
+  dummyBackend.write(bar, 40, dataContent.data(), 8);
+  dummyBackend.write(bar, 48, dataContent.data(), 4);
+  BOOST_CHECK_EQUAL(nCallsA, 0);
+  BOOST_CHECK_EQUAL(nCallsB, 1);
+  BOOST_CHECK_EQUAL(nCallsC, 0);
+  BOOST_CHECK_EQUAL(nCallsD, 2);
+
+  dummyBackend.close();
+  BOOST_CHECK_EQUAL(dummyBackend._readOnlyRanges.size(), 0);
+
+  // Registers need not be aligned: MODULE1.TEST_AREA starts at 0x25. The words are written to 0x25, 0x29, 0x2D, ...,
+  // so a read-only word at 0x2C only protects the third word of the area.
+  TestableDummyBackend unalignedBackend("goodMapFile.map");
+  unalignedBackend.open();
+  std::vector<int32_t> area(10, 0);
+  unalignedBackend.write(1, 0x25, area.data(), 4 * area.size());
+  unalignedBackend.setReadOnly(1, 0x2C, 1);
+  std::fill(area.begin(), area.end(), 7);
+  unalignedBackend.write(1, 0x25, area.data(), 4 * area.size());
+  unalignedBackend.read(1, 0x25, area.data(), 4 * area.size());
+  for (size_t i = 0; i < area.size(); ++i) {
+    BOOST_CHECK_EQUAL(area[i], i == 2 ? 0 : 7);
+  }
+}
+
 void DummyBackendTest::testFinalClosing() {
   // all features have to be enabled before closing
   TestableDummyBackend* dummyBackend = getBackendInstance();
   BOOST_CHECK(dummyBackend->_barContents.size() != 0);
-  BOOST_CHECK(dummyBackend->_readOnlyAddresses.size() != 0);
+  BOOST_CHECK(dummyBackend->_readOnlyRanges.size() != 0);
   BOOST_CHECK(dummyBackend->_writeCallbackFunctions.size() != 0);
 
   dummyBackend->close();
 
   // all features lists have to be empty now
-  BOOST_CHECK(dummyBackend->_readOnlyAddresses.size() == 0);
+  BOOST_CHECK(dummyBackend->_readOnlyRanges.size() == 0);
   BOOST_CHECK(dummyBackend->_writeCallbackFunctions.size() == 0);
 }
 
@@ -36,6 +36,7 @@ using namespace boost::unit_test_framework;
 #include "DeviceException.h"
 
 #include "FixedPointConverter.h"
+#include "FixedPointConverterT.h"
 namespace mtca4u{
   using namespace ChimeraTK;
 }
@@ -77,6 +78,12 @@ void checkToCookedOverflowNeg(FixedPointConverter const & converter, uint32_t in
     hasThrown = true;
   }
   if(!hasThrown) BOOST_FAIL(message.str());
+
+  // the bulk conversion must throw as well
+  std::vector<uint32_t> rawValues(3, input);
+  std::vector<T> cookedValues(3);
+  BOOST_CHECK_THROW(converter.template toCooked<T>(rawValues.data(), cookedValues.data(), rawValues.size()),
+                    boost::numeric::negative_overflow);
 }
 
 template<typename T>
@@ -93,6 +100,12 @@ void checkToCookedOverflowPos(FixedPointConverter const & converter, uint32_t in
     hasThrown = true;
   }
   if(!hasThrown) BOOST_FAIL(message.str());
+
+  // the bulk conversion must throw as well
+  std::vector<uint32_t> rawValues(3, input);
+  std::vector<T> cookedValues(3);
+  BOOST_CHECK_THROW(converter.template toCooked<T>(rawValues.data(), cookedValues.data(), rawValues.size()),
+                    boost::numeric::positive_overflow);
 }
 
 
@@ -112,6 +125,14 @@ void checkToCooked(FixedPointConverter const & converter,
   message << std::hex << ", output 0x" << result << std::dec;
 
   BOOST_CHECK_MESSAGE( result == expectedValue, message.str() );
+
+  // the bulk conversion must give the same result
+  std::vector<uint32_t> rawValues(3, input);
+  std::vector<T> cookedValues(3);
+  converter.template toCooked<T>(rawValues.data(), cookedValues.data(), rawValues.size());
+  for(auto &cooked : cookedValues) {
+    BOOST_CHECK_MESSAGE( cooked == expectedValue, message.str() + " (bulk conversion)" );
+  }
 }
 
 template<typename T>
@@ -129,6 +150,14 @@ void checkToRaw(FixedPointConverter const & converter,
   message << std::hex << ", output 0x" << result << std::dec;
 
   BOOST_CHECK_MESSAGE( result == expectedValue, message.str() );
+
+  // the bulk conversion must give the same result
+  std::vector<T> cookedValues(3, input);
+  std::vector<uint32_t> rawValues(3);
+  converter.toRaw(cookedValues.data(), rawValues.data(), cookedValues.size());
+  for(auto &raw : rawValues) {
+    BOOST_CHECK_MESSAGE( raw == expectedValue, message.str() + " (bulk conversion)" );
+  }
 }
 
 BOOST_AUTO_TEST_SUITE( FixedPointConverterTestSuite )
@@ -1523,4 +1552,210 @@ BOOST_AUTO_TEST_CASE( testDynamicRangeNeg ){
   BOOST_CHECK( pow(2., -(1024-16)) > 0. );
 }
 
+BOOST_AUTO_TEST_CASE( testBulkConversion ){
+  // compare the bulk conversion against the element-wise conversion for mixed positive and negative values
+  std::vector<uint32_t> rawValues = {0x0, 0x1, 0x1FFFF, 0x20000, 0x3FFFF, 0x2AAAA, 0x15555, 0xFFFFFFFF, 0x12345678};
+  std::vector<double> cookedValues = {0., 0.25, -0.25, 1023.99, 1024.2, -1024., -1024.3, 1e9, -1e9, 3.5, -3.5};
+
+  for(auto &converter : {FixedPointConverter("signed18", 18, 7, true), FixedPointConverter("unsigned18", 18, 7, false),
+                         FixedPointConverter("signed18int", 18, 0, true), FixedPointConverter("signed32", 32, 0, true),
+                         FixedPointConverter("unsigned32", 32, 0, false), FixedPointConverter("signed24frac", 24, 12, true)}) {
+    std::vector<double> doubleResult(rawValues.size());
+    converter.toCooked(rawValues.data(), doubleResult.data(), rawValues.size());
+    std::vector<int64_t> int64Result(rawValues.size());
+    converter.toCooked(rawValues.data(), int64Result.data(), rawValues.size());
+    for(size_t i = 0; i < rawValues.size(); ++i) {
+      BOOST_CHECK_EQUAL( doubleResult[i], converter.toCooked<double>(rawValues[i]) );
+      BOOST_CHECK_EQUAL( int64Result[i], converter.toCooked<int64_t>(rawValues[i]) );
+    }
+
+    std::vector<uint32_t> rawResult(cookedValues.size());
+    converter.toRaw(cookedValues.data(), rawResult.data(), cookedValues.size());
+    for(size_t i = 0; i < cookedValues.size(); ++i) {
+      BOOST_CHECK_EQUAL( rawResult[i], converter.toRaw(cookedValues[i]) );
+    }
+
+    std::vector<int32_t> intCookedValues = {0, 1, -1, 1023, 1024, 1025, -1024, -1025, 2147483647, -2147483647-1};
+    converter.toRaw(intCookedValues.data(), rawResult.data(), intCookedValues.size());
+    for(size_t i = 0; i < intCookedValues.size(); ++i) {
+      BOOST_CHECK_EQUAL( rawResult[i], converter.toRaw(intCookedValues[i]) );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( testSaturatingConversion ){
+  std::vector<uint32_t> rawValues = {0x0, 0x1, 0x7FFF, 0x8000, 0xFFFF, 0x10000, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+
+  // signed 32 bit to int16_t
+  FixedPointConverter signed32("signed32");
+  std::vector<int16_t> cooked16(rawValues.size());
+  BOOST_CHECK_EQUAL( signed32.toCookedSaturating(rawValues.data(), cooked16.data(), rawValues.size()), 5 );
+  std::vector<int16_t> expected16 = {0, 1, 32767, 32767, 32767, 32767, 32767, -32768, -1};
+  BOOST_CHECK( cooked16 == expected16 );
+
+  // unsigned 32 bit to int32_t and uint8_t
+  FixedPointConverter unsigned32("unsigned32", 32, 0, false);
+  std::vector<int32_t> cooked32(rawValues.size());
+  BOOST_CHECK_EQUAL( unsigned32.toCookedSaturating(rawValues.data(), cooked32.data(), rawValues.size()), 2 );
+  BOOST_CHECK_EQUAL( cooked32[6], 2147483647 );
+  BOOST_CHECK_EQUAL( cooked32[7], 2147483647 );
+  BOOST_CHECK_EQUAL( cooked32[8], 2147483647 );
+  std::vector<uint8_t> cooked8(rawValues.size());
+  BOOST_CHECK_EQUAL( unsigned32.toCookedSaturating(rawValues.data(), cooked8.data(), rawValues.size()), 7 );
+  BOOST_CHECK_EQUAL( cooked8[1], 1 );
+  BOOST_CHECK_EQUAL( cooked8[2], 255 );
+
+  // signed 18 bit with fractional bits to int8_t, values are rounded first
+  FixedPointConverter signed18("signed18", 18, 4, true);
+  std::vector<uint32_t> rawFrac = {0x7F7, 0x7F8, 0x3F808, 0x3F7F8};   // 127.4375, 127.5, -127.5, -128.5
+  std::vector<int8_t> cookedFrac(rawFrac.size());
+  BOOST_CHECK_EQUAL( signed18.toCookedSaturating(rawFrac.data(), cookedFrac.data(), rawFrac.size()), 2 );
+  std::vector<int8_t> expectedFrac = {127, 127, -128, -128};
+  BOOST_CHECK( cookedFrac == expectedFrac );
+
+  // large numbers of fractional bits to float
+  FixedPointConverter hugeFloat("hugeFloat", 32, -900, true);
+  std::vector<float> cookedFloat(3);
+  BOOST_CHECK_EQUAL( hugeFloat.toCookedSaturating(rawValues.data(), cookedFloat.data(), 3), 2 );
+  BOOST_CHECK_EQUAL( cookedFloat[0], 0. );
+  BOOST_CHECK_EQUAL( cookedFloat[1], std::numeric_limits<float>::max() );
+
+  // results without overflow are identical to the throwing conversion
+  std::vector<double> cookedDouble(rawValues.size()), expectedDouble(rawValues.size());
+  BOOST_CHECK_EQUAL( signed18.toCookedSaturating(rawValues.data(), cookedDouble.data(), rawValues.size()), 0 );
+  signed18.toCooked(rawValues.data(), expectedDouble.data(), rawValues.size());
+  BOOST_CHECK( cookedDouble == expectedDouble );
+  for(size_t i = 0; i < rawValues.size(); ++i) {
+    int32_t expected = 0;
+    try {
+      expected = signed32.toCooked<int16_t>(rawValues[i]);
+    }
+    catch(boost::numeric::bad_numeric_cast &) {
+      continue;
+    }
+    BOOST_CHECK_EQUAL( cooked16[i], expected );
+  }
+}
+
+template<typename UserType>
+void checkLookupTable(unsigned int nBits, int fractionalBits, bool isSignedFlag) {
+  FixedPointConverter plain("plain", nBits, fractionalBits, isSignedFlag);
+  FixedPointConverter withTable("withTable", nBits, fractionalBits, isSignedFlag);
+  withTable.enableLookupTable();
+  std::stringstream message;
+  message << "checkLookupTable failed for " << nBits << "," << fractionalBits << "," << isSignedFlag
+          << " and type " << typeName<UserType>();
+
+  // all possible raw values, plus some with unused bits set
+  std::vector<uint32_t> rawValues;
+  for(uint32_t raw = 0; raw < (1U << nBits); ++raw) rawValues.push_back(raw);
+  rawValues.push_back(0xFFFFFFFF);
+  rawValues.push_back(0xAAAA5555);
+
+  // element-wise comparison, including the thrown exceptions
+  for(auto raw : rawValues) {
+    UserType expected, result;
+    std::string expectedException, resultException;
+    try { plain.toCooked(&raw, &expected, 1); }
+    catch(boost::numeric::bad_numeric_cast &e) { expectedException = typeid(e).name(); }
+    try { withTable.toCooked(&raw, &result, 1); }
+    catch(boost::numeric::bad_numeric_cast &e) { resultException = typeid(e).name(); }
+    BOOST_CHECK_MESSAGE( expectedException == resultException, message.str() );
+    if(expectedException.empty()) BOOST_CHECK_MESSAGE( expected == result, message.str() );
+  }
+
+  // the saturating conversion gives identical results and overflow counts
+  std::vector<UserType> expected(rawValues.size()), result(rawValues.size());
+  size_t nExpected = plain.toCookedSaturating(rawValues.data(), expected.data(), rawValues.size());
+  size_t nResult = withTable.toCookedSaturating(rawValues.data(), result.data(), rawValues.size());
+  BOOST_CHECK_MESSAGE( nExpected == nResult, message.str() );
+  BOOST_CHECK_MESSAGE( expected == result, message.str() );
+}
+
+BOOST_AUTO_TEST_CASE( testLookupTable ){
+  checkLookupTable<int8_t>(8, 3, true);
+  checkLookupTable<int32_t>(8, 3, true);
+  checkLookupTable<uint8_t>(8, 3, true);
+  checkLookupTable<double>(8, 3, true);
+  checkLookupTable<int8_t>(12, 0, false);
+  checkLookupTable<uint16_t>(12, 0, false);
+  checkLookupTable<int16_t>(16, 5, true);
+  checkLookupTable<uint32_t>(16, 5, true);
+  checkLookupTable<float>(16, 5, true);
+  checkLookupTable<int16_t>(16, -2, false);
+  checkLookupTable<int64_t>(10, 9, true);
+  checkLookupTable<std::string>(10, 2, true);
+
+  // the lookup table survives a reconfiguration and is not used for wide converters
+  FixedPointConverter converter("converter", 12, 4, true);
+  converter.enableLookupTable();
+  converter.reconfigure(24, 4, true);
+  std::vector<uint32_t> rawValues = {0x0, 0x10, 0x7FFFFF, 0x800000};
+  std::vector<int32_t> cooked(rawValues.size());
+  converter.toCooked(rawValues.data(), cooked.data(), rawValues.size());
+  std::vector<int32_t> expected = {0, 1, 524288, -524288};
+  BOOST_CHECK( cooked == expected );
+  converter.reconfigure(8, 4, true);
+  rawValues = {0x0, 0x10, 0x7F, 0x80};
+  converter.toCooked(rawValues.data(), cooked.data(), rawValues.size());
+  expected = {0, 1, 8, -8};
+  BOOST_CHECK( cooked == expected );
+}
+
+template<unsigned int nBits, int fractionalBits, bool isSignedFlag, typename UserType>
+void checkCompileTimeConverter(const std::vector<uint32_t> &rawValues, const std::vector<UserType> &cookedValues) {
+  typedef FixedPointConverterT<nBits, fractionalBits, isSignedFlag> ConverterT;
+  FixedPointConverter converter("compileTime", nBits, fractionalBits, isSignedFlag);
+  std::stringstream message;
+  message << "checkCompileTimeConverter failed for " << nBits << "," << fractionalBits << "," << isSignedFlag
+          << " and type " << typeName<UserType>();
+
+  BOOST_CHECK_MESSAGE( ConverterT::template canConvertToCooked<UserType>(), message.str() );
+  std::vector<UserType> cookedResult(rawValues.size());
+  ConverterT::toCooked(rawValues.data(), cookedResult.data(), rawValues.size());
+  for(size_t i = 0; i < rawValues.size(); ++i) {
+    BOOST_CHECK_MESSAGE( cookedResult[i] == converter.toCooked<UserType>(rawValues[i]), message.str() );
+  }
+
+  auto toRawKernel = ConverterT::template getToRawKernel<UserType>();
+  BOOST_CHECK_MESSAGE( (toRawKernel != nullptr) == ConverterT::template canConvertToRaw<UserType>(), message.str() );
+  if(!toRawKernel) return;
+  std::vector<uint32_t> rawResult(cookedValues.size());
+  toRawKernel(cookedValues.data(), rawResult.data(), cookedValues.size());
+  for(size_t i = 0; i < cookedValues.size(); ++i) {
+    BOOST_CHECK_MESSAGE( rawResult[i] == converter.toRaw(cookedValues[i]), message.str() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( testCompileTimeConverter ){
+  std::vector<uint32_t> rawValues = {0x0, 0x1, 0x7F, 0x80, 0xFF, 0x7FFF, 0x8000, 0xFFFF, 0x1FFFF, 0x20000, 0x3FFFF,
+                                     0x2AAAA, 0x15555, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 0x12345678};
+  std::vector<int32_t> intValues = {0, 1, -1, 127, 128, -128, -129, 255, 256, 32767, 32768, -32768, -32769, 65535,
+                                    65536, 2147483647, -2147483647-1};
+  std::vector<double> doubleValues = {0., 0.25, -0.25, 0.75, -0.75, 1.5, -1.5, 1023.99, -1024.3, 1e9, -1e9};
+
+  checkCompileTimeConverter<32,0,true>(rawValues, intValues);
+  checkCompileTimeConverter<32,0,true>(rawValues, std::vector<int64_t>(intValues.begin(), intValues.end()));
+  checkCompileTimeConverter<32,0,true>(rawValues, doubleValues);
+  checkCompileTimeConverter<32,0,false>(rawValues, std::vector<uint32_t>(intValues.begin(), intValues.end()));
+  checkCompileTimeConverter<32,0,false>(rawValues, doubleValues);
+  checkCompileTimeConverter<16,0,true>(rawValues, intValues);
+  checkCompileTimeConverter<16,0,true>(rawValues, std::vector<int16_t>(intValues.begin(), intValues.end()));
+  checkCompileTimeConverter<16,0,false>(rawValues, std::vector<uint16_t>(intValues.begin(), intValues.end()));
+  checkCompileTimeConverter<16,0,false>(rawValues, std::vector<float>(doubleValues.begin(), doubleValues.end()));
+  checkCompileTimeConverter<8,0,true>(rawValues, std::vector<int8_t>(intValues.begin(), intValues.end()));
+  checkCompileTimeConverter<18,17,true>(rawValues, doubleValues);
+  checkCompileTimeConverter<18,17,true>(rawValues, std::vector<float>(doubleValues.begin(), doubleValues.end()));
+  checkCompileTimeConverter<18,0,true>(rawValues, intValues);
+
+  // conversions which might overflow are not available
+  BOOST_CHECK( !(FixedPointConverterT<32,0,true>::canConvertToCooked<int16_t>()) );
+  BOOST_CHECK( !(FixedPointConverterT<16,0,true>::canConvertToCooked<uint32_t>()) );
+  BOOST_CHECK( !(FixedPointConverterT<18,17,true>::canConvertToCooked<int32_t>()) );
+  BOOST_CHECK( !(FixedPointConverterT<18,17,true>::canConvertToRaw<float>()) );
+  BOOST_CHECK( !(FixedPointConverterT<32,0,true>::canConvertToCooked<std::string>()) );
+  BOOST_CHECK( (FixedPointConverterT<32,0,true>::getToCookedKernel<int16_t>() == nullptr) );
+  BOOST_CHECK( (FixedPointConverterT<32,0,true>::getToCookedKernel<int32_t>() != nullptr) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
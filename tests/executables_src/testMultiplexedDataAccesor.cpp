@@ -8,6 +8,7 @@ using namespace boost::unit_test_framework;
 #include <sstream>
 
 #include "TwoDRegisterAccessor.h"
+#include "ContiguousTwoDRegisterAccessor.h"
 #include "NumericAddressedBackendMuxedRegisterAccessor.h"
 #include "DummyBackend.h"
 #include "MapFileParser.h"
@@ -276,6 +277,41 @@ BOOST_AUTO_TEST_CASE(testReadWriteToDMARegion) {
 
 }
 
+BOOST_AUTO_TEST_CASE(testContiguousAccessor) {
+  BackendFactory::getInstance().setDMapFilePath(DMAP_FILE_NAME);
+  Device device;
+  device.open(DEVICE_ALIAS);
+
+  TwoDRegisterAccessor<double> deMultiplexer = device.getTwoDRegisterAccessor<double>(TEST_MODULE_PATH/"DMA");
+  ContiguousTwoDRegisterAccessor<double> contiguous(device.getTwoDRegisterAccessor<double>(TEST_MODULE_PATH/"DMA"));
+  BOOST_CHECK_EQUAL( contiguous.getNChannels(), deMultiplexer.getNChannels() );
+  BOOST_CHECK_EQUAL( contiguous.getNElementsPerChannel(), deMultiplexer.getNElementsPerChannel() );
+  size_t nSamples = contiguous.getNElementsPerChannel();
+
+  // the channels are views into one channel-major array. The sequences have -2 fractional bits, so only multiples of
+  // 4 are represented exactly.
+  for(size_t channel = 0; channel < contiguous.getNChannels(); ++channel) {
+    BOOST_CHECK_EQUAL( contiguous[channel].size(), nSamples );
+    BOOST_CHECK( contiguous[channel].data() == contiguous.data() + channel*nSamples );
+    for(size_t i = 0; i < nSamples; ++i) contiguous[channel][i] = channel*100 + 4*i;
+  }
+  contiguous.write();
+
+  deMultiplexer.read();
+  for(size_t channel = 0; channel < deMultiplexer.getNChannels(); ++channel) {
+    for(size_t i = 0; i < nSamples; ++i) BOOST_CHECK( deMultiplexer[channel][i] == channel*100 + 4*i );
+  }
+
+  deMultiplexer[3][1] = 44;
+  deMultiplexer.write();
+  contiguous.read();
+  BOOST_CHECK( contiguous[3][1] == 44 );
+  BOOST_CHECK( contiguous.data()[3*nSamples + 1] == 44 );
+  double sum = 0;
+  for(auto &value : contiguous[2]) sum += value;
+  BOOST_CHECK( sum == 200*nSamples + 2*nSamples*(nSamples-1) );
+}
+
 BOOST_AUTO_TEST_CASE(testMixed) {
 
   // open a dummy device with the sequence map file
@@ -224,6 +224,107 @@ BOOST_AUTO_TEST_CASE( testRawWithTransferGroup ){
 
 }
 
+BOOST_AUTO_TEST_CASE( testInt32WithoutConversion ){
+  Device device;
+  device.open("sdm://./dummy=goodMapFile.map");
+
+  // APP0.MODULE0 is a 32 bit signed register without fractional bits, so the int32_t accessor exchanges the buffers
+  // with the low-level transfer element instead of converting
+  auto accessor = device.getOneDRegisterAccessor<int32_t>("APP0/MODULE0");
+  auto raw = device.getOneDRegisterAccessor<int32_t>("APP0/MODULE0", 0, 0, {AccessMode::raw});
+  auto asDouble = device.getOneDRegisterAccessor<double>("APP0/MODULE0");
+
+  accessor[0] = -42;
+  accessor[1] = 2147483647;
+  // writing twice must not lose the buffer content
+  for(int i = 0; i < 2; ++i) {
+    accessor.write();
+    BOOST_CHECK_EQUAL( accessor[0], -42 );
+    BOOST_CHECK_EQUAL( accessor[1], 2147483647 );
+    raw.read();
+    BOOST_CHECK_EQUAL( raw[0], -42 );
+    BOOST_CHECK_EQUAL( raw[1], 2147483647 );
+  }
+  asDouble.read();
+  BOOST_CHECK_EQUAL( asDouble[0], -42. );
+
+  raw[0] = 0x12345678;
+  raw[1] = -1;
+  raw.write();
+  for(int i = 0; i < 2; ++i) {
+    accessor.read();
+    BOOST_CHECK_EQUAL( accessor[0], 0x12345678 );
+    BOOST_CHECK_EQUAL( accessor[1], -1 );
+  }
+
+  // also inside a TransferGroup, where the low-level transfer element is shared
+  auto word0 = device.getScalarRegisterAccessor<int32_t>("APP0/MODULE0");
+  auto word1 = device.getScalarRegisterAccessor<int32_t>("APP0/MODULE0", 1);
+  TransferGroup group;
+  group.addAccessor(word0);
+  group.addAccessor(word1);
+  group.read();
+  BOOST_CHECK_EQUAL( int32_t(word0), 0x12345678 );
+  BOOST_CHECK_EQUAL( int32_t(word1), -1 );
+  word0 = 5;
+  word1 = -6;
+  group.write();
+  raw.read();
+  BOOST_CHECK_EQUAL( raw[0], 5 );
+  BOOST_CHECK_EQUAL( raw[1], -6 );
+}
+
+BOOST_AUTO_TEST_CASE( testSaturate ){
+  Device device;
+  device.open("sdm://./dummy=goodMapFile.map");
+
+  // TEST_AREA is a 32 bit unsigned register
+  auto raw = device.getOneDRegisterAccessor<int32_t>("MODULE1/TEST_AREA", 4, 0,  {AccessMode::raw});
+  raw[0] = 42;
+  raw[1] = -1;                // 0xFFFFFFFF: too big for int16_t and int32_t
+  raw[2] = 0x8000;            // too big for int16_t only
+  raw[3] = 0x7FFF;
+  raw.write();
+
+  // without the flag, reading throws
+  auto throwing = device.getOneDRegisterAccessor<int16_t>("MODULE1/TEST_AREA", 4);
+  BOOST_CHECK_THROW( throwing.read(), boost::numeric::bad_numeric_cast );
+  BOOST_CHECK_EQUAL( throwing.getNumberOfOverflows(), 0 );
+
+  // with the flag, the values are saturated and counted
+  auto saturated = device.getOneDRegisterAccessor<int16_t>("MODULE1/TEST_AREA", 4, 0,  {AccessMode::saturate});
+  saturated.read();
+  BOOST_CHECK_EQUAL( saturated[0], 42 );
+  BOOST_CHECK_EQUAL( saturated[1], 32767 );
+  BOOST_CHECK_EQUAL( saturated[2], 32767 );
+  BOOST_CHECK_EQUAL( saturated[3], 32767 );
+  BOOST_CHECK_EQUAL( saturated.getNumberOfOverflows(), 2 );
+
+  auto saturated32 = device.getOneDRegisterAccessor<int32_t>("MODULE1/TEST_AREA", 4, 0,  {AccessMode::saturate});
+  saturated32.read();
+  BOOST_CHECK_EQUAL( saturated32[1], 2147483647 );
+  BOOST_CHECK_EQUAL( saturated32[2], 0x8000 );
+  BOOST_CHECK_EQUAL( saturated32.getNumberOfOverflows(), 1 );
+
+  // the count is per transfer
+  raw[1] = 0;
+  raw[2] = 0;
+  raw.write();
+  saturated.read();
+  BOOST_CHECK_EQUAL( saturated[1], 0 );
+  BOOST_CHECK_EQUAL( saturated.getNumberOfOverflows(), 0 );
+
+  // the saturate flag also works inside a TransferGroup
+  raw[1] = -1;
+  raw.write();
+  TransferGroup group;
+  group.addAccessor(saturated);
+  group.addAccessor(saturated32);
+  group.read();
+  BOOST_CHECK_EQUAL( saturated[1], 32767 );
+  BOOST_CHECK_EQUAL( saturated.getNumberOfOverflows(), 1 );
+  BOOST_CHECK_EQUAL( saturated32.getNumberOfOverflows(), 1 );
+}
 
 // After you finished all test you have to end the test suite.
 BOOST_AUTO_TEST_SUITE_END()
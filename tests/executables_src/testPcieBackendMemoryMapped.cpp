@@ -0,0 +1,158 @@
+#define BOOST_TEST_DYN_LINK
+// Define a name for the test module.
+#define BOOST_TEST_MODULE PcieBackendMemoryMappedTest
+// Only after defining the name include the unit test header.
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+#include "BackendFactory.h"
+#include "DeviceAccessVersion.h"
+#include "Device.h"
+#include "PcieBackend.h"
+#include "PcieBackendException.h"
+namespace mtca4u{
+  using namespace ChimeraTK;
+}
+using namespace mtca4u;
+
+// A regular file is used as a stand-in for the device node, so these tests do not need the hardware or a driver.
+#define STAND_IN_FILE "pcieBackendStandIn.img"
+
+// PcieBackend::createInstance() only accepts device nodes in /dev, so a backend type for the stand-in file is
+// registered. The parameters are the same as for the pci backend: the map file and optionally "mmap".
+// The last created backend is kept, so the tests can check which bars are mapped.
+static boost::shared_ptr<PcieBackend> lastCreatedBackend;
+
+static boost::shared_ptr<DeviceBackend> createStandInBackend(std::string, std::string,
+    std::list<std::string> parameters, std::string) {
+  bool useMmap = parameters.size() > 1 && parameters.back() == "mmap";
+  lastCreatedBackend.reset(new PcieBackend(STAND_IN_FILE, parameters.front(), useMmap));
+  return lastCreatedBackend;
+}
+
+struct RegisterStandInBackend {
+  RegisterStandInBackend() {
+    BackendFactory::getInstance().registerBackendType("pcieStandIn", "", &createStandInBackend,
+        CHIMERATK_DEVICEACCESS_VERSION);
+  }
+};
+
+// Create a test suite which holds all your tests.
+BOOST_FIXTURE_TEST_SUITE( PcieBackendMemoryMappedTestSuite, RegisterStandInBackend )
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE( testFileStandIn ){
+  std::remove(STAND_IN_FILE);
+  std::ofstream(STAND_IN_FILE).close();
+
+  Device device;
+  device.open("sdm://./pcieStandIn=goodMapFile.map");
+  BOOST_CHECK(device.readDeviceInfo().find(STAND_IN_FILE) != std::string::npos);
+
+  auto accessor = device.getOneDRegisterAccessor<int32_t>("APP0/MODULE0", 0, 0, {AccessMode::raw});
+  accessor[0] = 0x12345678;
+  accessor[1] = -42;
+  accessor.write();
+  device.close();
+
+  // bar 0 occupies the first page, so bar 1 starts at the second page of the file
+  std::ifstream file(STAND_IN_FILE, std::ios::binary);
+  file.seekg(sysconf(_SC_PAGESIZE) + 0x10);
+  int32_t fileContent[2];
+  file.read(reinterpret_cast<char*>(fileContent), sizeof(fileContent));
+  BOOST_CHECK(file.good());
+  BOOST_CHECK_EQUAL(fileContent[0], 0x12345678);
+  BOOST_CHECK_EQUAL(fileContent[1], -42);
+
+  // the content persists when opening again
+  device.open("sdm://./pcieStandIn=goodMapFile.map");
+  accessor.replace(device.getOneDRegisterAccessor<int32_t>("APP0/MODULE0", 0, 0, {AccessMode::raw}));
+  accessor.read();
+  BOOST_CHECK_EQUAL(accessor[0], 0x12345678);
+  BOOST_CHECK_EQUAL(accessor[1], -42);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE( testMemoryMappedAccess ){
+  std::remove(STAND_IN_FILE);
+  std::ofstream(STAND_IN_FILE).close();
+
+  // one device uses the memory mapping, the other one the system calls. Both see the same content.
+  Device mapped, unmapped;
+  mapped.open("sdm://./pcieStandIn=goodMapFile.map,mmap");
+  auto mappedBackend = lastCreatedBackend;
+  unmapped.open("sdm://./pcieStandIn=goodMapFile.map");
+  BOOST_REQUIRE(mappedBackend->isBarMapped(1));
+  BOOST_CHECK(!lastCreatedBackend->isBarMapped(1));
+
+  auto mappedModule = mapped.getOneDRegisterAccessor<int32_t>("APP0/MODULE0", 0, 0, {AccessMode::raw});
+  auto unmappedModule = unmapped.getOneDRegisterAccessor<int32_t>("APP0/MODULE0", 0, 0, {AccessMode::raw});
+  mappedModule[0] = 17;
+  mappedModule[1] = -1;
+  mappedModule.write();
+  unmappedModule.read();
+  BOOST_CHECK_EQUAL(unmappedModule[0], 17);
+  BOOST_CHECK_EQUAL(unmappedModule[1], -1);
+
+  unmappedModule[0] = 0x7FFFFFFF;
+  unmappedModule[1] = 0;
+  unmappedModule.write();
+  mappedModule.read();
+  BOOST_CHECK_EQUAL(mappedModule[0], 0x7FFFFFFF);
+  BOOST_CHECK_EQUAL(mappedModule[1], 0);
+
+  // cooked access with fixed point conversion through the mapping
+  auto mappedUser = mapped.getScalarRegisterAccessor<double>("MODULE0/WORD_USER1");
+  auto unmappedUser = unmapped.getScalarRegisterAccessor<double>("MODULE0/WORD_USER1");
+  mappedUser = 2.5;
+  mappedUser.write();
+  unmappedUser.read();
+  BOOST_CHECK_CLOSE(double(unmappedUser), 2.5, 1e-6);
+
+  // registers which are not word aligned fall back to the system calls
+  auto mappedArea = mapped.getOneDRegisterAccessor<int32_t>("MODULE1/TEST_AREA");
+  auto unmappedArea = unmapped.getOneDRegisterAccessor<int32_t>("MODULE1/TEST_AREA");
+  for(size_t i = 0; i < mappedArea.getNElements(); ++i) mappedArea[i] = 100 + i;
+  mappedArea.write();
+  unmappedArea.read();
+  for(size_t i = 0; i < unmappedArea.getNElements(); ++i) BOOST_CHECK_EQUAL(unmappedArea[i], int32_t(100 + i));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE( testMemoryMappedDmaBar ){
+  std::remove(STAND_IN_FILE);
+  std::ofstream(STAND_IN_FILE).close();
+
+  // the stand-in has the DMA bar 0xD as a separate region, which is mapped like the other bars
+  Device mapped, unmapped;
+  mapped.open("sdm://./pcieStandIn=mtcadummy.map,mmap");
+  BOOST_REQUIRE(lastCreatedBackend->isBarMapped(0xD));
+  unmapped.open("sdm://./pcieStandIn=mtcadummy.map");
+
+  auto mappedDma = mapped.getOneDRegisterAccessor<int32_t>("ADC/AREA_DMA_VIA_DMA", 0, 0, {AccessMode::raw});
+  auto unmappedDma = unmapped.getOneDRegisterAccessor<int32_t>("ADC/AREA_DMA_VIA_DMA", 0, 0, {AccessMode::raw});
+  for(size_t i = 0; i < unmappedDma.getNElements(); ++i) unmappedDma[i] = 3*i;
+  unmappedDma.write();
+  mappedDma.read();
+  for(size_t i = 0; i < mappedDma.getNElements(); ++i) BOOST_CHECK_EQUAL(mappedDma[i], int32_t(3*i));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE( testStandInWithoutMapFile ){
+  std::ofstream(STAND_IN_FILE).close();
+  PcieBackend backend(STAND_IN_FILE, "", true);
+  BOOST_CHECK_THROW(backend.open(), PcieBackendException);
+  BOOST_CHECK(!backend.isOpen());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_SUITE_END()
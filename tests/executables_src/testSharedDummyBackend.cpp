@@ -0,0 +1,363 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SharedDummyBackendTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <list>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SharedDummyBackend.h"
+#include "DummyBackend.h"
+#include "ExperimentalFeatures.h"
+#include "NDRegisterAccessor.h"
+#include "OneDRegisterAccessor.h"
+#include "ReadAnyGroup.h"
+#include "ReadAsyncThreadPool.h"
+#include "TransferGroup.h"
+
+using namespace ChimeraTK;
+
+#define TEST_MAPPING_FILE "mtcadummy_withoutModules.map"
+
+// Each test run uses its own shared memory, so an aborted earlier run does not interfere. The id is determined once,
+// so forked child processes use the same instance.
+static std::string instanceId() {
+  static const std::string id = "testSharedDummyBackend_" + std::to_string(getpid());
+  return id;
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadWriteBetweenInstances) {
+  // two backends on the same instance share the register contents, like two processes would
+  SharedDummyBackend firstBackend(instanceId(), TEST_MAPPING_FILE);
+  SharedDummyBackend secondBackend(instanceId(), TEST_MAPPING_FILE);
+  firstBackend.open();
+  secondBackend.open();
+
+  std::vector<int32_t> dataToWrite = {1, 2, 3, 4};
+  firstBackend.write(0, 0x20, dataToWrite.data(), 16);
+  std::vector<int32_t> readData(4, 0);
+  secondBackend.read(0, 0x20, readData.data(), 16);
+  BOOST_CHECK(readData == dataToWrite);
+
+  // a block in another bar
+  std::vector<int32_t> block(0x400);
+  for(size_t i = 0; i < block.size(); ++i) block[i] = 3 * i;
+  secondBackend.write(2, 0, block.data(), 4 * block.size());
+  std::vector<int32_t> readBlock(0x400, 0);
+  firstBackend.read(2, 0, readBlock.data(), 4 * readBlock.size());
+  BOOST_CHECK(readBlock == block);
+
+  // invalid accesses
+  BOOST_CHECK_THROW(firstBackend.read(2, 4, readBlock.data(), 4 * readBlock.size()), DeviceException);
+  BOOST_CHECK_THROW(firstBackend.write(2, 0x1000, block.data(), 4), DeviceException);
+  BOOST_CHECK_THROW(firstBackend.read(1, 0, readBlock.data(), 4), DeviceException);
+  BOOST_CHECK_THROW(firstBackend.read(0, 0x20, readData.data(), 6), DeviceException);
+
+  firstBackend.close();
+  BOOST_CHECK_THROW(firstBackend.read(0, 0x20, readData.data(), 16), DeviceException);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConsistentSnapshots) {
+  SharedDummyBackend writingBackend(instanceId(), TEST_MAPPING_FILE);
+  SharedDummyBackend readingBackend(instanceId(), TEST_MAPPING_FILE);
+  writingBackend.open();
+  readingBackend.open();
+
+  // Each write sets all words of the area to the same value. Readers must never see a mixture of two writes.
+  const size_t nWords = 0x400;
+  std::vector<int32_t> writeData(nWords, 0);
+  writingBackend.write(2, 0, writeData.data(), 4 * nWords);
+
+  std::atomic<bool> writerFinished(false);
+  std::atomic<int> nInconsistentReads(0);
+  std::vector<std::thread> readers;
+  for(int i = 0; i < 3; ++i) {
+    readers.emplace_back([&] {
+      std::vector<int32_t> readData(nWords);
+      while(!writerFinished) {
+        readingBackend.read(2, 0, readData.data(), 4 * nWords);
+        if(std::count(readData.begin(), readData.end(), readData[0]) != static_cast<long>(nWords)) {
+          ++nInconsistentReads;
+        }
+      }
+    });
+  }
+  for(int32_t i = 1; i <= 2000; ++i) {
+    std::fill(writeData.begin(), writeData.end(), i);
+    writingBackend.write(2, 0, writeData.data(), 4 * nWords);
+  }
+  writerFinished = true;
+  for(auto &reader : readers) reader.join();
+
+  BOOST_CHECK_EQUAL(nInconsistentReads, 0);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testOtherProcess) {
+  SharedDummyBackend backend(instanceId(), TEST_MAPPING_FILE);
+  backend.open();
+  int32_t value = 0;
+  backend.write(0, 0x40, &value, 4);
+
+  pid_t child = fork();
+  BOOST_REQUIRE(child >= 0);
+  if(child == 0) {
+    // the child process writes the register through its own backend
+    int exitCode = 0;
+    try {
+      SharedDummyBackend childBackend(instanceId(), TEST_MAPPING_FILE);
+      childBackend.open();
+      int32_t childValue = 42;
+      childBackend.write(0, 0x40, &childValue, 4);
+    }
+    catch(...) {
+      exitCode = 1;
+    }
+    _exit(exitCode);
+  }
+
+  int status;
+  waitpid(child, &status, 0);
+  BOOST_REQUIRE(WIFEXITED(status));
+  BOOST_CHECK_EQUAL(WEXITSTATUS(status), 0);
+  backend.read(0, 0x40, &value, 4);
+  BOOST_CHECK_EQUAL(value, 42);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testWaitForNewData) {
+  boost::shared_ptr<SharedDummyBackend> backend(new SharedDummyBackend(instanceId(), TEST_MAPPING_FILE));
+  backend->open();
+  auto accessor = backend->getRegisterAccessor<int32_t>("WORD_CLK_MUX", 0, 0, {AccessMode::wait_for_new_data});
+
+  // only writes after the creation of the accessor are new data
+  BOOST_CHECK(!accessor->readNonBlocking());
+
+  // writes to other registers of the bar are ignored
+  int32_t value = 5;
+  backend->write(0, 0x40, &value, 4);
+  BOOST_CHECK(!accessor->readNonBlocking());
+
+  // a write to a part of the register is new data
+  backend->write(0, 0x24, &value, 4);
+  BOOST_CHECK(accessor->readNonBlocking());
+  BOOST_CHECK_EQUAL(accessor->accessData(1), 5);
+  BOOST_CHECK(!accessor->readNonBlocking());
+
+  // more writes than fit into the ring buffer of written ranges are conservatively reported as new data
+  for(int i = 0; i < 100; ++i) backend->write(0, 0x40, &value, 4);
+  BOOST_CHECK(accessor->readNonBlocking());
+
+  // a blocking read waits for the write of another process
+  pid_t child = fork();
+  BOOST_REQUIRE(child >= 0);
+  if(child == 0) {
+    int exitCode = 0;
+    try {
+      SharedDummyBackend childBackend(instanceId(), TEST_MAPPING_FILE);
+      childBackend.open();
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      int32_t childValue = 42;
+      childBackend.write(0, 0x20, &childValue, 4);
+    }
+    catch(...) {
+      exitCode = 1;
+    }
+    _exit(exitCode);
+  }
+  accessor->read();
+  BOOST_CHECK_EQUAL(accessor->accessData(0), 42);
+  int status;
+  waitpid(child, &status, 0);
+  BOOST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // the same with readAsync()
+  ExperimentalFeatures::enable();
+  TransferFuture &future = accessor->readAsync();
+  BOOST_CHECK(!future.hasNewData());
+  value = 7;
+  backend->write(0, 0x2C, &value, 4);
+  future.wait();
+  BOOST_CHECK_EQUAL(accessor->accessData(3), 7);
+
+  // a TransferGroup cannot wait for new data, so such accessors are rejected
+  {
+    OneDRegisterAccessor<int32_t> waitingAccessor(accessor);
+    TransferGroup group;
+    BOOST_CHECK_THROW(group.addAccessor(waitingAccessor), DeviceException);
+    OneDRegisterAccessor<int32_t> pollingAccessor(backend->getRegisterAccessor<int32_t>("WORD_CLK_MUX", 0, 0, {}));
+    group.addAccessor(pollingAccessor);
+    group.read();
+    BOOST_CHECK_EQUAL(pollingAccessor[3], 7);
+  }
+
+  // destroying the accessor cancels a waiting readAsync()
+  accessor->readAsync();
+  accessor.reset();
+
+  // backends which cannot notify do not support the flag
+  BOOST_CHECK_THROW(boost::shared_ptr<DeviceBackend>(new DummyBackend(TEST_MAPPING_FILE))->
+      getRegisterAccessor<int32_t>("WORD_CLK_MUX", 0, 0, {AccessMode::wait_for_new_data}), DeviceException);
+}
+
+/**********************************************************************************************************************/
+
+// Name of the segment used by the SharedDummyBackend, to simulate a segment created by another process
+static std::string segmentName(const std::string &instance) {
+  return "ChimeraTK_SharedDummy_" + std::to_string(std::hash<std::string>{}(TEST_MAPPING_FILE)) + "_" +
+         std::to_string(std::hash<std::string>{}(instance));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testGrowSegment) {
+  // A process has mapped a segment which is too small for the bars (e.g. created with a different size estimate).
+  std::string instance = instanceId() + "_grow";
+  boost::interprocess::managed_shared_memory peerSegment(boost::interprocess::create_only,
+      segmentName(instance).c_str(), 4096);
+
+  {
+    SharedDummyBackend backend(instance, TEST_MAPPING_FILE);
+    backend.open();
+    BOOST_CHECK(peerSegment.get_size() > 4096);
+
+    // the grown segment is usable by all instances
+    SharedDummyBackend secondBackend(instance, TEST_MAPPING_FILE);
+    secondBackend.open();
+    int32_t value = 17;
+    backend.write(2, 0xFFC, &value, 4);
+    value = 0;
+    secondBackend.read(2, 0xFFC, &value, 4);
+    BOOST_CHECK_EQUAL(value, 17);
+  }
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSegmentDirectory) {
+  // The sandbox of the tests has no hugetlbfs mount, but any directory can hold the segment file.
+  std::string instance = instanceId() + "_file";
+  std::string fileName = "./" + segmentName(instance);
+  {
+    // also grow a file segment
+    boost::interprocess::managed_mapped_file peerSegment(boost::interprocess::create_only, fileName.c_str(), 4096);
+
+    SharedDummyBackend backend(instance, TEST_MAPPING_FILE, ".");
+    SharedDummyBackend secondBackend(instance, TEST_MAPPING_FILE, ".");
+    backend.open();
+    secondBackend.open();
+    BOOST_CHECK(peerSegment.get_size() > 4096);
+
+    std::vector<int32_t> block(0x400);
+    for(size_t i = 0; i < block.size(); ++i) block[i] = 5 * i;
+    backend.write(2, 0, block.data(), 4 * block.size());
+    std::vector<int32_t> readBlock(0x400, 0);
+    secondBackend.read(2, 0, readBlock.data(), 4 * readBlock.size());
+    BOOST_CHECK(readBlock == block);
+    BOOST_CHECK(access(fileName.c_str(), F_OK) == 0);
+  }
+  // the last instance removes the file
+  BOOST_CHECK(access(fileName.c_str(), F_OK) != 0);
+
+  BOOST_CHECK_THROW(SharedDummyBackend(instance, TEST_MAPPING_FILE, "./doesNotExist"), DeviceException);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDeadWriter) {
+  SharedDummyBackend backend(instanceId(), TEST_MAPPING_FILE);
+  backend.open();
+  int32_t value = 3;
+  backend.write(0, 0x40, &value, 4);
+
+  // the id of a process which does not exist any more
+  pid_t child = fork();
+  BOOST_REQUIRE(child >= 0);
+  if(child == 0) _exit(0);
+  int status;
+  waitpid(child, &status, 0);
+
+  // A process which has died during a write leaves the bar locked with an odd sequence counter
+  boost::interprocess::managed_shared_memory segment(boost::interprocess::open_only,
+      segmentName(instanceId()).c_str());
+  std::atomic<uint32_t> *sequence = segment.find<std::atomic<uint32_t>>("Bar0_sequence").first;
+  std::atomic<pid_t> *owner = segment.find<std::atomic<pid_t>>("Bar0_owner").first;
+  BOOST_REQUIRE(sequence != nullptr && owner != nullptr);
+  ++*sequence;
+  *owner = child;
+
+  // readers release the bar
+  value = 0;
+  backend.read(0, 0x40, &value, 4);
+  BOOST_CHECK_EQUAL(value, 3);
+  BOOST_CHECK_EQUAL(*sequence % 2, 0);
+  BOOST_CHECK_EQUAL(*owner, 0);
+
+  // so do writers
+  ++*sequence;
+  *owner = child;
+  value = 4;
+  backend.write(0, 0x40, &value, 4);
+  value = 0;
+  backend.read(0, 0x40, &value, 4);
+  BOOST_CHECK_EQUAL(value, 4);
+
+  // a bar locked by a living process cannot be accessed, but the access does not hang
+  ++*sequence;
+  *owner = getpid();
+  BOOST_CHECK_THROW(backend.read(0, 0x40, &value, 4), DeviceException);
+  BOOST_CHECK_THROW(backend.write(0, 0x40, &value, 4), DeviceException);
+  ++*sequence;
+  *owner = 0;
+  backend.write(0, 0x40, &value, 4);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMoreWaitingAccessorsThanThreads) {
+  // Each waiting transfer blocks a thread of the ReadAsyncThreadPool, but must not use up its maximum number of
+  // threads: all accessors still see their updates.
+  ExperimentalFeatures::enable();
+  boost::shared_ptr<SharedDummyBackend> backend(new SharedDummyBackend(instanceId(), TEST_MAPPING_FILE));
+  backend->open();
+  size_t nAccessors = ReadAsyncThreadPool::getInstance().getMaxNumberOfThreads() + 4;
+  std::vector<OneDRegisterAccessor<int32_t>> accessors;
+  for(size_t i = 0; i < nAccessors; ++i) {
+    accessors.emplace_back(backend->getRegisterAccessor<int32_t>("AREA_DMAABLE", 1, i,
+        {AccessMode::wait_for_new_data}));
+  }
+
+  {
+    ReadAnyGroup group(std::list<std::reference_wrapper<TransferElementAbstractor>>(accessors.begin(),
+        accessors.end()));
+
+    // the accessors whose transfers have been started last are written first
+    for(size_t i = nAccessors; i-- > 0;) {
+      int32_t value = 100 + i;
+      backend->write(2, 4*i, &value, 4);
+      BOOST_CHECK(group.readAny() == accessors[i].getId());
+      BOOST_CHECK_EQUAL(accessors[i][0], value);
+    }
+
+    // other tasks of the pool are not starved by the waiting transfers either
+    OneDRegisterAccessor<int32_t> writer(backend->getRegisterAccessor<int32_t>("WORD_CLK_RST", 1, 0, {}));
+    writer[0] = 12;
+    std::promise<void> written;
+    writer.writeAsync([](std::function<void()> handler) { handler(); },
+        [&written](bool, boost::exception_ptr) { written.set_value(); });
+    BOOST_CHECK(written.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  }
+}
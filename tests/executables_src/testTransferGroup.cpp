@@ -1,10 +1,19 @@
 ///@todo FIXME My dynamic init header is a hack. Change the test to use BOOST_AUTO_TEST_CASE!
 #include "boost_dynamic_init_test.h"
 
+#include <sstream>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+
 #include "TransferGroup.h"
 #include "BufferingRegisterAccessor.h"
 #include "NumericAddressedLowLevelTransferElement.h"
 #include "Device.h"
+#include "DummyBackend.h"
+#include "BackendFactory.h"
+#include "DeviceAccessVersion.h"
 #include "NDRegisterAccessorDecorator.h"
 
 #include "accessPrivateData.h"
@@ -57,6 +66,10 @@ class TransferGroupTest {
     void testMergeNumericRegistersDifferentTypes();
     void testCallsToPrePostFunctionsInDecorator();
     void testCallsToPrePostFunctionsInLowLevel();
+    void testVectoredTransfer();
+    void testMergeWithGap();
+    void testParallelTransfers();
+    void testParallelTransfersBackendOrder();
 };
 
 class TransferGroupTestSuite : public test_suite {
@@ -70,10 +83,142 @@ class TransferGroupTestSuite : public test_suite {
       add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testMergeNumericRegistersDifferentTypes, transferGroupTest) );
       add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testCallsToPrePostFunctionsInDecorator, transferGroupTest) );
       add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testCallsToPrePostFunctionsInLowLevel, transferGroupTest) );
+      add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testVectoredTransfer, transferGroupTest) );
+      add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testMergeWithGap, transferGroupTest) );
+      add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testParallelTransfers, transferGroupTest) );
+      add( BOOST_CLASS_TEST_CASE(&TransferGroupTest::testParallelTransfersBackendOrder, transferGroupTest) );
+    }
+};
+
+/** DummyBackend which counts the calls to readv() and writev(), and to read() and write() */
+class VectorCountingDummy : public DummyBackend {
+  public:
+    explicit VectorCountingDummy(std::string mapFileName) : DummyBackend(mapFileName) {}
+
+    static boost::shared_ptr<DeviceBackend> createInstance(std::string, std::string, std::list<std::string> parameters, std::string) {
+      return boost::shared_ptr<DeviceBackend>(new VectorCountingDummy(parameters.front()));
+    }
+
+    void readv(const std::vector<TransferRange> &ranges) override {
+      nReadv++;
+      lastNumberOfRanges = ranges.size();
+      DummyBackend::readv(ranges);
+    }
+
+    void writev(const std::vector<TransferRange> &ranges) override {
+      nWritev++;
+      lastNumberOfRanges = ranges.size();
+      DummyBackend::writev(ranges);
+    }
+
+    void read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes) override {
+      nRead++;
+      DummyBackend::read(bar, address, data, sizeInBytes);
+    }
+
+    void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes) override {
+      nWrite++;
+      DummyBackend::write(bar, address, data, sizeInBytes);
     }
+
+    size_t nReadv{0};
+    size_t nWritev{0};
+    size_t lastNumberOfRanges{0};
+    size_t nRead{0};
+    size_t nWrite{0};
+};
+
+/** DummyBackend whose transfers only complete if another instance is transferring at the same time */
+class ConcurrencyCheckingDummy : public DummyBackend {
+  public:
+    explicit ConcurrencyCheckingDummy(std::string mapFileName) : DummyBackend(mapFileName) {}
+
+    static boost::shared_ptr<DeviceBackend> createInstance(std::string, std::string, std::list<std::string> parameters, std::string) {
+      return boost::shared_ptr<DeviceBackend>(new ConcurrencyCheckingDummy(parameters.front()));
+    }
+
+    void readv(const std::vector<TransferRange> &ranges) override {
+      waitForOtherTransfer();
+      DummyBackend::readv(ranges);
+    }
+
+    void writev(const std::vector<TransferRange> &ranges) override {
+      waitForOtherTransfer();
+      DummyBackend::writev(ranges);
+    }
+
+    /// Count the transfer and wait until nConcurrent transfers have been counted. A timeout is counted in nTimeouts.
+    void waitForOtherTransfer() {
+      std::unique_lock<std::mutex> lock(concurrencyMutex);
+      ++nTransfers;
+      concurrencyCondition.notify_all();
+      size_t target = (nTransfers + nConcurrent - 1) / nConcurrent * nConcurrent;
+      if(!concurrencyCondition.wait_for(lock, std::chrono::seconds(5), [target] { return nTransfers >= target; })) {
+        ++nTimeouts;
+      }
+    }
+
+    static std::mutex concurrencyMutex;
+    static std::condition_variable concurrencyCondition;
+    static size_t nTransfers;
+    static size_t nConcurrent;
+    static size_t nTimeouts;
+};
+std::mutex ConcurrencyCheckingDummy::concurrencyMutex;
+std::condition_variable ConcurrencyCheckingDummy::concurrencyCondition;
+size_t ConcurrencyCheckingDummy::nTransfers{0};
+size_t ConcurrencyCheckingDummy::nConcurrent{2};
+size_t ConcurrencyCheckingDummy::nTimeouts{0};
+
+/** DummyBackend which records the kind of each transfer call and the thread calling it */
+class ThreadRecordingDummy : public DummyBackend {
+  public:
+    explicit ThreadRecordingDummy(std::string mapFileName) : DummyBackend(mapFileName) {}
+
+    static boost::shared_ptr<DeviceBackend> createInstance(std::string, std::string, std::list<std::string> parameters, std::string) {
+      return boost::shared_ptr<DeviceBackend>(new ThreadRecordingDummy(parameters.front()));
+    }
+
+    void readv(const std::vector<TransferRange> &ranges) override {
+      record("readv");
+      DummyBackend::readv(ranges);
+    }
+
+    void writev(const std::vector<TransferRange> &ranges) override {
+      record("writev");
+      DummyBackend::writev(ranges);
+    }
+
+    void read(uint8_t bar, uint32_t address, int32_t* data,  size_t sizeInBytes) override {
+      record("read");
+      DummyBackend::read(bar, address, data, sizeInBytes);
+    }
+
+    void write(uint8_t bar, uint32_t address, int32_t const* data,  size_t sizeInBytes) override {
+      record("write");
+      DummyBackend::write(bar, address, data, sizeInBytes);
+    }
+
+    void record(const std::string &call) {
+      std::lock_guard<std::mutex> lock(callsMutex);
+      calls.push_back(call);
+      threads.push_back(std::this_thread::get_id());
+    }
+
+    std::mutex callsMutex;
+    std::vector<std::string> calls;
+    std::vector<std::thread::id> threads;
 };
 
 bool init_unit_test(){
+  BackendFactory::getInstance().registerBackendType("VectorCountingDummy","",&VectorCountingDummy::createInstance,
+                                                    CHIMERATK_DEVICEACCESS_VERSION);
+  BackendFactory::getInstance().registerBackendType("ConcurrencyCheckingDummy","",
+                                                    &ConcurrencyCheckingDummy::createInstance,
+                                                    CHIMERATK_DEVICEACCESS_VERSION);
+  BackendFactory::getInstance().registerBackendType("ThreadRecordingDummy","",
+                                                    &ThreadRecordingDummy::createInstance,
+                                                    CHIMERATK_DEVICEACCESS_VERSION);
   framework::master_test_suite().p_name.value = "TransferGroup class test suite";
   framework::master_test_suite().add(new TransferGroupTestSuite());
 
@@ -901,3 +1046,221 @@ void TransferGroupTest::testCallsToPrePostFunctionsInLowLevel() {
   }
 
 }
+
+/**********************************************************************************************************************/
+
+void TransferGroupTest::testVectoredTransfer() {
+
+  mtca4u::Device device;
+  device.open("sdm://./VectorCountingDummy=mtcadummy.map");
+  auto backend = boost::dynamic_pointer_cast<VectorCountingDummy>(
+      BackendFactory::getInstance().createBackend("sdm://./VectorCountingDummy=mtcadummy.map"));
+  BOOST_REQUIRE(backend != nullptr);
+
+  // two registers which will be merged and one register in a different address range
+  auto mux0 = device.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_0");
+  auto mux1 = device.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_1");
+  auto status = device.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+
+  TransferGroup group;
+  group.addAccessor(mux0);
+  group.addAccessor(mux1);
+  group.addAccessor(status);
+
+  // all transfers of the group go through a single call to writev() resp. readv()
+  mux0 = 11;
+  mux1 = 22;
+  status = 33;
+  group.write();
+  BOOST_CHECK_EQUAL(backend->nWritev, 1);
+  BOOST_CHECK_EQUAL(backend->lastNumberOfRanges, 2);
+  // the overridden write() of derived backends still sees each range
+  BOOST_CHECK_EQUAL(backend->nWrite, 2);
+
+  auto mux0b = device.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_0");
+  auto mux1b = device.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_1");
+  auto statusb = device.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+  mux0b.read();
+  mux1b.read();
+  statusb.read();
+  BOOST_CHECK( mux0b == 11 );
+  BOOST_CHECK( mux1b == 22 );
+  BOOST_CHECK( statusb == 33 );
+
+  mux0b = 44;
+  mux0b.write();
+  statusb = 55;
+  statusb.write();
+  size_t nReadBefore = backend->nRead;
+  group.read();
+  BOOST_CHECK_EQUAL(backend->nReadv, 1);
+  BOOST_CHECK_EQUAL(backend->lastNumberOfRanges, 2);
+  BOOST_CHECK_EQUAL(backend->nRead - nReadBefore, 2);
+  BOOST_CHECK( mux0 == 44 );
+  BOOST_CHECK( mux1 == 22 );
+  BOOST_CHECK( status == 55 );
+
+}
+
+/**********************************************************************************************************************/
+
+void TransferGroupTest::testMergeWithGap() {
+
+  mtca4u::Device device;
+  device.open("sdm://./VectorCountingDummy=mtcadummy.map");
+  auto backend = boost::dynamic_pointer_cast<VectorCountingDummy>(
+      BackendFactory::getInstance().createBackend("sdm://./VectorCountingDummy=mtcadummy.map"));
+  BOOST_REQUIRE(backend != nullptr);
+
+  // WORD_FIRMWARE and WORD_STATUS are separated by WORD_COMPILATION (4 bytes), ADC/WORD_CLK_MUX_0 is further away
+  auto firmware = device.getScalarRegisterAccessor<int>("/BOARD/WORD_FIRMWARE");
+  auto status = device.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+  auto mux0 = device.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_0");
+  auto compilation = device.getScalarRegisterAccessor<int>("/BOARD/WORD_COMPILATION");
+
+  TransferGroup group;
+  group.setMaxMergeGap(4);
+  group.addAccessor(firmware);
+  group.addAccessor(status);
+  group.addAccessor(mux0);
+
+  // check the transfer plan
+  std::stringstream plan;
+  group.dump(plan);
+  BOOST_CHECK(plan.str().find("with 2 range(s)") != std::string::npos);
+  BOOST_CHECK(plan.str().find("bar 0, address 0, 12 bytes (4 bytes unused, not written)") != std::string::npos);
+  BOOST_CHECK(plan.str().find("bar 0, address 32, 4 bytes") != std::string::npos);
+
+  // the register in the gap is read but not written
+  compilation = 77;
+  compilation.write();
+  firmware = 1;
+  status = 2;
+  mux0 = 3;
+  group.write();
+  BOOST_CHECK_EQUAL(backend->lastNumberOfRanges, 3);
+  compilation.read();
+  BOOST_CHECK( compilation == 77 );
+
+  auto firmwareb = device.getScalarRegisterAccessor<int>("/BOARD/WORD_FIRMWARE");
+  auto statusb = device.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+  firmwareb.read();
+  statusb.read();
+  BOOST_CHECK( firmwareb == 1 );
+  BOOST_CHECK( statusb == 2 );
+
+  firmwareb = 10;
+  firmwareb.write();
+  statusb = 20;
+  statusb.write();
+  group.read();
+  BOOST_CHECK_EQUAL(backend->lastNumberOfRanges, 2);
+  BOOST_CHECK( firmware == 10 );
+  BOOST_CHECK( status == 20 );
+  BOOST_CHECK( mux0 == 3 );
+
+  // without the gap tolerance, the registers are not merged
+  auto firmware2 = device.getScalarRegisterAccessor<int>("/BOARD/WORD_FIRMWARE");
+  auto status2 = device.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+  TransferGroup group2;
+  group2.addAccessor(firmware2);
+  group2.addAccessor(status2);
+  group2.read();
+  BOOST_CHECK_EQUAL(backend->lastNumberOfRanges, 2);
+  BOOST_CHECK( firmware2 == 10 );
+  BOOST_CHECK( status2 == 20 );
+
+}
+
+/**********************************************************************************************************************/
+
+void TransferGroupTest::testParallelTransfers() {
+
+  // two independent backends. Their transfers only complete without timeout if they run at the same time.
+  mtca4u::Device device1, device2;
+  device1.open("sdm://./ConcurrencyCheckingDummy=mtcadummy.map");
+  device2.open("sdm://./ConcurrencyCheckingDummy=goodMapFile.map");
+
+  auto status1 = device1.getScalarRegisterAccessor<int>("/BOARD/WORD_STATUS");
+  auto mux1 = device1.getScalarRegisterAccessor<int>("/ADC/WORD_CLK_MUX_0");
+  auto user2 = device2.getScalarRegisterAccessor<int>("/MODULE0/WORD_USER1");
+
+  TransferGroup group;
+  group.setParallelTransfers(true);
+  group.addAccessor(status1);
+  group.addAccessor(mux1);
+  group.addAccessor(user2);
+
+  status1 = 5;
+  mux1 = 6;
+  user2 = 7;
+  group.write();
+  BOOST_CHECK_EQUAL(ConcurrencyCheckingDummy::nTransfers, 2);
+  BOOST_CHECK_EQUAL(ConcurrencyCheckingDummy::nTimeouts, 0);
+
+  status1 = 0;
+  mux1 = 0;
+  user2 = 0;
+  group.read();
+  BOOST_CHECK_EQUAL(ConcurrencyCheckingDummy::nTransfers, 4);
+  BOOST_CHECK_EQUAL(ConcurrencyCheckingDummy::nTimeouts, 0);
+  BOOST_CHECK( status1 == 5 );
+  BOOST_CHECK( mux1 == 6 );
+  BOOST_CHECK( user2 == 7 );
+
+  // exceptions from any backend are passed on after all transfers have completed
+  device2.close();
+  BOOST_CHECK_THROW(group.read(), ChimeraTK::Exception);
+  device2.open();
+
+  std::stringstream plan;
+  group.dump(plan);
+  BOOST_CHECK(plan.str().find("backends in parallel") != std::string::npos);
+
+}
+
+/**********************************************************************************************************************/
+
+void TransferGroupTest::testParallelTransfersBackendOrder() {
+
+  // a multiplexed 2D register cannot be merged into writev(), but must still be transferred in the same thread as
+  // the other registers of its backend, and before them
+  mtca4u::Device device1, device2;
+  device1.open("sdm://./ThreadRecordingDummy=muxedDataAcessor.map");
+  device2.open("sdm://./ThreadRecordingDummy=goodMapFile.map");
+  auto backend1 = boost::dynamic_pointer_cast<ThreadRecordingDummy>(
+      BackendFactory::getInstance().createBackend("sdm://./ThreadRecordingDummy=muxedDataAcessor.map"));
+  BOOST_REQUIRE(backend1 != nullptr);
+
+  auto muxed1 = device1.getTwoDRegisterAccessor<int>("TEST","NODMA");
+  auto area1 = device1.getOneDRegisterAccessor<int>("AREA_DMAABLE", 1, 512);
+  auto user2 = device2.getScalarRegisterAccessor<int>("/MODULE0/WORD_USER1");
+
+  TransferGroup group;
+  group.setParallelTransfers(true);
+  group.addAccessor(muxed1);
+  group.addAccessor(area1);
+  group.addAccessor(user2);
+
+  muxed1[3][0] = 42;
+  area1[0] = 43;
+  user2 = 44;
+  group.write();
+  BOOST_REQUIRE_GE(backend1->calls.size(), 2);
+  BOOST_CHECK_EQUAL(backend1->calls[0], "write");
+  BOOST_CHECK_EQUAL(backend1->calls[1], "writev");
+  for(auto &thread : backend1->threads) BOOST_CHECK(thread == backend1->threads.front());
+
+  backend1->calls.clear();
+  backend1->threads.clear();
+  muxed1[3][0] = 0;
+  area1[0] = 0;
+  group.read();
+  BOOST_REQUIRE_GE(backend1->calls.size(), 2);
+  BOOST_CHECK_EQUAL(backend1->calls[0], "read");
+  BOOST_CHECK_EQUAL(backend1->calls[1], "readv");
+  for(auto &thread : backend1->threads) BOOST_CHECK(thread == backend1->threads.front());
+  BOOST_CHECK_EQUAL(muxed1[3][0], 42);
+  BOOST_CHECK_EQUAL(area1[0], 43);
+
+}
@@ -2,7 +2,7 @@
 
 TEST_RESULT=0
 
-for PROTOCO_VERSION in 0 1; do
+for PROTOCO_VERSION in 0 1 2; do
 
     #start the server with the protocol version to test against
     ../bin/RebotDummyServer -m ./mtcadummy_rebot.map -V $PROTOCO_VERSION&
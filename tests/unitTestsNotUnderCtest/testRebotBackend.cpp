@@ -5,12 +5,16 @@
 #include "boost_dynamic_init_test.h"
 #include "BackendFactory.h"
 #include "RebotBackend.h"
+#include "RebotBackendException.h"
 #include "Device.h"
 
 #include "Utilities.h"
 #include "DMapFileParser.h"
 #include "NumericAddress.h"
 
+#include <atomic>
+#include <thread>
+
 namespace mtca4u{
   using namespace ChimeraTK;
 }
@@ -38,6 +42,8 @@ class RebotTestClass {
     explicit RebotTestClass(std::string const& cardAlias);
     void testConnection();
     void testReadWriteAPIOfRebotBackend();
+    void testPipelinedTransfers();
+    void testConnectionPool();
 
   private:
     /*
@@ -60,6 +66,8 @@ class RebotDeviceTestSuite : public test_suite {
       boost::shared_ptr<RebotTestClass> rebotTest(new RebotTestClass(cardAlias));
       add(BOOST_CLASS_TEST_CASE(&RebotTestClass::testConnection, rebotTest));
       add(BOOST_CLASS_TEST_CASE(&RebotTestClass::testReadWriteAPIOfRebotBackend, rebotTest));
+      add(BOOST_CLASS_TEST_CASE(&RebotTestClass::testPipelinedTransfers, rebotTest));
+      add(BOOST_CLASS_TEST_CASE(&RebotTestClass::testConnectionPool, rebotTest));
     }
 };
 
@@ -127,6 +135,10 @@ void RebotTestClass::testConnection() { // BAckend test
   BOOST_CHECK_EQUAL(rebotBackend.isConnected(), true);
   BOOST_CHECK_EQUAL(rebotBackend.isOpen(), true);
 
+  // the connection pool can only be changed while closed
+  BOOST_CHECK_THROW(rebotBackend.setNumberOfConnections(2), mtca4u::RebotBackendException);
+  BOOST_CHECK_THROW(rebotBackend.setNumberOfConnections(0), mtca4u::RebotBackendException);
+
   //BOOST_CHECK_THROW(secondConnectionToServer.open(), mtca4u::RebotBackendException);
 
   BOOST_CHECK_NO_THROW(rebotBackend.close());
@@ -185,3 +197,97 @@ void RebotTestClass::testReadWriteAPIOfRebotBackend() {
     BOOST_CHECK_EQUAL(test_area_data[i], test_area_ReadIndata[i]);
   }
 }
+
+void RebotTestClass::testPipelinedTransfers() {
+  mtca4u::RebotBackend rebotBackend(_rebotServer.ip, _rebotServer.port);
+  rebotBackend.open();
+
+  // Split the test area into more ranges than the default pipeline depth. The last range is larger
+  // than the read block size of protocol version 0.
+  uint32_t test_area_Addr = 0x00000030;
+  std::vector<uint32_t> rangeSizesInWords(40, 3);
+  rangeSizesInWords.push_back(500);
+
+  for (size_t pipelineDepth : {1, 4, 16}) {
+    rebotBackend.setPipelineDepth(pipelineDepth);
+
+    std::vector<int32_t> dataToWrite(1024);
+    std::vector<int32_t> readInData(1024, 0);
+    for (auto &value : dataToWrite) {
+      value = rand();
+    }
+
+    std::vector<mtca4u::NumericAddressedBackend::TransferRange> writeRanges, readRanges;
+    uint32_t offsetInWords = 0;
+    for (auto nWords : rangeSizesInWords) {
+      writeRanges.push_back({0, test_area_Addr + 4*offsetInWords, dataToWrite.data() + offsetInWords, 4*nWords});
+      readRanges.push_back({0, test_area_Addr + 4*offsetInWords, readInData.data() + offsetInWords, 4*nWords});
+      offsetInWords += nWords;
+    }
+
+    rebotBackend.writev(writeRanges);
+    rebotBackend.readv(readRanges);
+    for (uint32_t i = 0; i < offsetInWords; ++i) {
+      BOOST_CHECK_EQUAL(dataToWrite[i], readInData[i]);
+    }
+
+    // the connection is still in sync with the server
+    int32_t readValue = 0;
+    rebotBackend.read(0, 0x04, &readValue, sizeof(readValue));
+    BOOST_CHECK_EQUAL(0xDEADBEEF, readValue);
+  }
+
+  BOOST_CHECK_THROW(rebotBackend.setPipelineDepth(0), mtca4u::RebotBackendException);
+}
+
+void RebotTestClass::testConnectionPool() {
+  mtca4u::RebotBackend rebotBackend(_rebotServer.ip, _rebotServer.port);
+  rebotBackend.setNumberOfConnections(3);
+  // The test area is too small for the default striping threshold
+  rebotBackend.setMinStripedReadSize(256);
+  rebotBackend.open();
+
+  // a striped read returns the data in the right order
+  uint32_t test_area_Addr = 0x00000030;
+  std::vector<int32_t> dataToWrite(1000);
+  std::vector<int32_t> readInData(1000, 0);
+  for (auto &value : dataToWrite) {
+    value = rand();
+  }
+  rebotBackend.write(0, test_area_Addr, dataToWrite.data(), 4*dataToWrite.size());
+  rebotBackend.read(0, test_area_Addr, readInData.data(), 4*readInData.size());
+  for (size_t i = 0; i < dataToWrite.size(); ++i) {
+    BOOST_CHECK_EQUAL(dataToWrite[i], readInData[i]);
+  }
+
+  // concurrent transfers on the pool. Each thread uses its own part of the test area.
+  const size_t nThreads = 4;
+  const size_t nWordsPerThread = 100;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> nErrors(0);
+  for (size_t t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&, t] {
+      uint32_t address = test_area_Addr + 4*t*nWordsPerThread;
+      std::vector<int32_t> threadData(nWordsPerThread), threadReadInData(nWordsPerThread);
+      try {
+        for (int32_t iteration = 0; iteration < 20; ++iteration) {
+          for (size_t i = 0; i < nWordsPerThread; ++i) {
+            threadData[i] = 1000*iteration + i + 100000*t;
+          }
+          rebotBackend.write(0, address, threadData.data(), 4*nWordsPerThread);
+          rebotBackend.read(0, address, threadReadInData.data(), 4*nWordsPerThread);
+          if (threadData != threadReadInData) ++nErrors;
+        }
+      }
+      catch (...) {
+        ++nErrors;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(nErrors, 0);
+
+  rebotBackend.close();
+}